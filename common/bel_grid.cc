@@ -0,0 +1,62 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "bel_grid.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+BelGrid::BelGrid(const Context *ctx)
+{
+    // First pass: number the types, find the grid size and count the bels in each slot
+    std::vector<std::pair<int, Loc>> bel_slots;
+    for (auto bel : ctx->getBels()) {
+        IdString type = ctx->getBelType(bel);
+        auto ins = type_lookup.emplace(type, int(types.size()));
+        if (ins.second)
+            types.push_back(type);
+        Loc loc = ctx->getBelLocation(bel);
+        width = std::max(width, loc.x + 1);
+        height = std::max(height, loc.y + 1);
+        bel_slots.emplace_back(ins.first->second, loc);
+    }
+
+    offsets.assign(num_slots() + 1, 0);
+    for (auto &s : bel_slots)
+        ++offsets.at(slot_index(s.first, s.second.x, s.second.y) + 1);
+    for (int i = 0; i < num_slots(); i++)
+        offsets.at(i + 1) += offsets.at(i);
+
+    // Second pass: fill in the bels, keeping getBels() order within each slot
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    bels.resize(bel_slots.size());
+    size_t i = 0;
+    for (auto bel : ctx->getBels()) {
+        auto &s = bel_slots.at(i++);
+        bels.at(fill.at(slot_index(s.first, s.second.x, s.second.y))++) = bel;
+    }
+}
+
+const BelGrid &Context::getBelGrid()
+{
+    if (!bel_grid)
+        bel_grid = std::make_shared<const BelGrid>(this);
+    return *bel_grid;
+}
+
+NEXTPNR_NAMESPACE_END
@@ -0,0 +1,99 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef BEL_GRID_H
+#define BEL_GRID_H
+
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Every bel of the device, grouped by type and then by tile into one array, with offsets giving the range of each
+// (type, x, y) slot. Types are numbered in the order they are first seen in getBels(), and the bels of one type are
+// also a single range. This only depends on the Arch, so is built once and shared through Context::getBelGrid();
+// users keep any placement-dependent state in their own arrays indexed by bel_index() or slot_index().
+struct BelGrid
+{
+    struct Range
+    {
+        const BelId *b, *e;
+        // Index of the first bel of the range, see bel_index()
+        int first;
+
+        const BelId *begin() const { return b; }
+        const BelId *end() const { return e; }
+        int size() const { return int(e - b); }
+        bool empty() const { return b == e; }
+        const BelId &operator[](int i) const { return b[i]; }
+    };
+
+    explicit BelGrid(const Context *ctx);
+
+    // One more than the largest x and y of any bel
+    int width = 0, height = 0;
+
+    int num_types() const { return int(types.size()); }
+    int num_bels() const { return int(bels.size()); }
+    int num_slots() const { return num_types() * width * height; }
+    IdString type_name(int type) const { return types.at(type); }
+    // Returns -1 if there are no bels of this type
+    int type_index(IdString type) const
+    {
+        auto fnd = type_lookup.find(type);
+        return fnd == type_lookup.end() ? -1 : fnd->second;
+    }
+
+    // Index of a (type, x, y) slot in [0, num_slots()), or -1 if the type is -1 or x or y is outside the grid
+    int slot_index(int type, int x, int y) const
+    {
+        if (type < 0 || type >= num_types() || x < 0 || y < 0 || x >= width || y >= height)
+            return -1;
+        return (type * width + x) * height + y;
+    }
+    // Index of bel i of a range in [0, num_bels()), for indexing per-bel arrays
+    static int bel_index(const Range &r, int i) { return r.first + i; }
+
+    Range bels_at(int type, int x, int y) const
+    {
+        int slot = slot_index(type, x, y);
+        if (slot == -1)
+            return range(0, 0);
+        return range(offsets[slot], offsets[slot + 1]);
+    }
+    int count_at(int type, int x, int y) const { return bels_at(type, x, y).size(); }
+    Range bels_of_type(int type) const
+    {
+        int first = slot_index(type, 0, 0);
+        if (first == -1)
+            return range(0, 0);
+        return range(offsets[first], offsets[first + width * height]);
+    }
+
+  private:
+    std::vector<IdString> types;
+    std::unordered_map<IdString, int> type_lookup;
+    std::vector<int> offsets; // num_slots() + 1 entries
+    std::vector<BelId> bels;
+
+    Range range(int begin, int end) const { return Range{bels.data() + begin, bels.data() + end, begin}; }
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
@@ -138,10 +138,30 @@ po::options_description CommandHandler::getGeneralOptions()
                         "; default: " + Arch::defaultPlacer)
                     .c_str());
 
+    general.add_options()("threads", po::value<int>(), "number of threads to use where supported");
+    general.add_options()("reroute-incremental",
+                          "keep existing routing that is still legal, and only reroute nets that changed (router2)");
+    general.add_options()("report-route-perf", po::value<std::string>(),
+                          "write router performance counters for each iteration to a JSON file (router2)");
+    general.add_options()("report-place-perf", po::value<std::string>(),
+                          "write placement quality and runtime figures to a JSON file (HeAP and SA placers)");
+
     general.add_options()("slack_redist_iter", po::value<int>(), "number of iterations between slack redistribution");
     general.add_options()("cstrweight", po::value<float>(), "placer weighting for relative constraint satisfaction");
     general.add_options()("starttemp", po::value<float>(), "placer SA start temperature");
     general.add_options()("placer-budgets", "use budget rather than criticality in placer timing weights");
+    general.add_options()("placer-sa-parallel",
+                          "anneal windows of the device on several threads once SA moves are small (xilinx only)");
+    general.add_options()("placer-heap-solver", po::value<std::string>(),
+                          "equation solver for the HeAP placer: cg (default) or iccg");
+    general.add_options()("placer-heap-net-model", po::value<std::string>(),
+                          "net model for the HeAP placer: b2b (default), star or hybrid");
+    general.add_options()("placer-heap-solver-threads", po::value<int>(),
+                          "number of OpenMP threads for the HeAP equation solver (default: --threads)");
+    general.add_options()("placer-heap-slr-partition",
+                          "partition the design between the dies of multi-die devices before HeAP placement");
+    general.add_options()("placer-heap-parallel-legalise",
+                          "legalise regions of the device on several threads in the HeAP placer (xilinx only)");
 
     general.add_options()("pack-only", "pack design only without placement or routing");
     general.add_options()("no-route", "process design without routing");
@@ -229,6 +249,40 @@ void CommandHandler::setupContext(Context *ctx)
         ctx->settings[ctx->id("router")] = router;
     }
 
+    if (vm.count("reroute-incremental"))
+        ctx->settings[ctx->id("router2/incremental")] = true;
+
+    if (vm.count("report-route-perf"))
+        ctx->settings[ctx->id("router2/perfReport")] = vm["report-route-perf"].as<std::string>();
+
+    if (vm.count("report-place-perf"))
+        ctx->settings[ctx->id("placer/perfReport")] = vm["report-place-perf"].as<std::string>();
+
+    if (vm.count("threads")) {
+        int threads = vm["threads"].as<int>();
+        if (threads < 1)
+            log_error("Number of threads must be at least 1\n");
+        ctx->settings[ctx->id("threads")] = threads;
+    }
+
+    if (vm.count("placer-heap-solver"))
+        ctx->settings[ctx->id("placerHeap/solver")] = vm["placer-heap-solver"].as<std::string>();
+
+    if (vm.count("placer-heap-net-model"))
+        ctx->settings[ctx->id("placerHeap/netModel")] = vm["placer-heap-net-model"].as<std::string>();
+
+    if (vm.count("placer-heap-solver-threads")) {
+        int threads = vm["placer-heap-solver-threads"].as<int>();
+        if (threads < 1)
+            log_error("Number of solver threads must be at least 1\n");
+        ctx->settings[ctx->id("placerHeap/solverThreads")] = threads;
+    }
+
+    if (vm.count("placer-heap-slr-partition"))
+        ctx->settings[ctx->id("placerHeap/slrPartition")] = true;
+    if (vm.count("placer-heap-parallel-legalise"))
+        ctx->settings[ctx->id("placerHeap/parallelLegalise")] = true;
+
     if (vm.count("cstrweight")) {
         ctx->settings[ctx->id("placer1/constraintWeight")] = std::to_string(vm["cstrweight"].as<float>());
     }
@@ -239,6 +293,8 @@ void CommandHandler::setupContext(Context *ctx)
     if (vm.count("placer-budgets")) {
         ctx->settings[ctx->id("placer1/budgetBased")] = true;
     }
+    if (vm.count("placer-sa-parallel"))
+        ctx->settings[ctx->id("placer1/parallel")] = true;
     if (vm.count("freq")) {
         auto freq = vm["freq"].as<double>();
         if (freq > 0)
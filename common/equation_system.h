@@ -0,0 +1,164 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2019  David Shah <david@symbioticeda.com>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef EQUATION_SYSTEM_H
+#define EQUATION_SYSTEM_H
+
+#include <Eigen/Core>
+#include <Eigen/IterativeLinearSolvers>
+#include <Eigen/SparseCore>
+#include <algorithm>
+#include <vector>
+#include "nextpnr.h"
+#include "placer_heap.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// A simple internal representation for a sparse system of equations Ax = rhs
+// This is designed to decouple the functions that build the matrix to the engine that
+// solves it, and the representation that requires
+//
+// Coefficients are collected as unsorted triplets, with duplicates summed on assembly. The assembled matrix and the
+// solver are kept between solves: while every coefficient falls within the sparsity pattern of the previous matrix,
+// only its values are rewritten and the solver's analysis of the pattern is kept. Any missing entry causes the
+// matrix to be rebuilt from the triplets and analysed again.
+//
+// The matrix is stored row-major, so that with OpenMP Eigen runs the sparse matrix-vector products of CG in parallel.
+template <typename T> struct EquationSystem
+{
+    EquationSystem() {}
+    EquationSystem(size_t rows, size_t cols) { resize(rows, cols); }
+
+    std::vector<Eigen::Triplet<T>> A; // (row, col, x[row, col]) in insertion order, possibly repeated
+    std::vector<T> rhs;               // RHS vector
+
+    // Resizing the system forgets the cached sparsity pattern
+    void resize(size_t rows, size_t cols)
+    {
+        NPNR_ASSERT(rows == cols);
+        if (rows != rhs.size() || int(cols) != mat.cols())
+            pattern_valid = false;
+        rhs.resize(rows);
+        reset();
+    }
+
+    void set_solver(PlacerHeapCfg::SolverType type)
+    {
+        if (type != solver_type)
+            pattern_valid = false;
+        solver_type = type;
+    }
+
+    void reset()
+    {
+        A.clear();
+        std::fill(rhs.begin(), rhs.end(), T());
+    }
+
+    void add_coeff(int row, int col, T val) { A.emplace_back(row, col, val); }
+
+    void add_rhs(int row, T val) { rhs[row] += val; }
+
+    // Number of times the matrix has been assembled from the triplets and its pattern analysed
+    int rebuild_count() const { return rebuilds; }
+
+    void solve(std::vector<T> &x, float tolerance)
+    {
+        using namespace Eigen;
+        if (x.empty())
+            return;
+        NPNR_ASSERT(x.size() == rhs.size());
+
+        bool reanalyse = !update_values();
+        if (reanalyse) {
+            mat.resize(x.size(), x.size());
+            mat.setFromTriplets(A.begin(), A.end());
+            pattern_valid = true;
+            ++rebuilds;
+        }
+
+        VectorXd vx(x.size()), vb(rhs.size());
+        for (int i = 0; i < int(x.size()); i++)
+            vx[i] = x.at(i);
+        for (int i = 0; i < int(rhs.size()); i++)
+            vb[i] = rhs.at(i);
+
+        VectorXd xr;
+        bool solved = false;
+        if (solver_type == PlacerHeapCfg::SOLVER_ICCG)
+            solved = run_solver(ic_solver, reanalyse, tolerance, vb, vx, xr);
+        // Incomplete Cholesky can break down on a badly conditioned system, in which case fall back to plain CG
+        if (!solved) {
+            if (solver_type != PlacerHeapCfg::SOLVER_CG)
+                reanalyse = true;
+            run_solver(cg_solver, reanalyse, tolerance, vb, vx, xr);
+        }
+        for (int i = 0; i < int(x.size()); i++)
+            x.at(i) = xr[i];
+        // for (int i = 0; i < int(x.size()); i++)
+        //    log_info("x[%d] = %f\n", i, x.at(i));
+    }
+
+  private:
+    typedef Eigen::SparseMatrix<T, Eigen::RowMajor> Matrix;
+    Matrix mat;
+    Eigen::ConjugateGradient<Matrix, Eigen::Lower | Eigen::Upper> cg_solver;
+    Eigen::ConjugateGradient<Matrix, Eigen::Lower | Eigen::Upper, Eigen::IncompleteCholesky<T>> ic_solver;
+    PlacerHeapCfg::SolverType solver_type = PlacerHeapCfg::SOLVER_CG;
+    bool pattern_valid = false;
+    int rebuilds = 0;
+
+    template <typename Solver>
+    bool run_solver(Solver &solver, bool reanalyse, float tolerance, const Eigen::VectorXd &vb,
+                    const Eigen::VectorXd &vx, Eigen::VectorXd &xr)
+    {
+        if (reanalyse)
+            solver.analyzePattern(mat);
+        solver.setTolerance(tolerance);
+        solver.factorize(mat);
+        if (solver.info() != Eigen::Success)
+            return false;
+        xr = solver.solveWithGuess(vb, vx);
+        return true;
+    }
+
+    // Write the coefficients into the existing matrix, returning false if any is outside its sparsity pattern
+    bool update_values()
+    {
+        if (!pattern_valid)
+            return false;
+        T *values = mat.valuePtr();
+        const auto *cols = mat.innerIndexPtr();
+        const auto *row_start = mat.outerIndexPtr();
+        std::fill(values, values + mat.nonZeros(), T());
+        for (auto &t : A) {
+            auto begin = cols + row_start[t.row()], end = cols + row_start[t.row() + 1];
+            auto fnd = std::lower_bound(begin, end, t.col());
+            if (fnd == end || *fnd != t.col())
+                return false;
+            values[fnd - cols] += t.value();
+        }
+        return true;
+    }
+};
+
+
+NEXTPNR_NAMESPACE_END
+
+#endif
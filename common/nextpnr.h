@@ -846,6 +846,8 @@ NEXTPNR_NAMESPACE_END
 
 NEXTPNR_NAMESPACE_BEGIN
 
+struct BelGrid;
+
 struct Context : Arch, DeterministicRNG
 {
     bool verbose = false;
@@ -865,6 +867,11 @@ struct Context : Arch, DeterministicRNG
     bool getActualRouteDelay(WireId src_wire, WireId dst_wire, delay_t *delay = nullptr,
                              std::unordered_map<WireId, PipId> *route = nullptr, bool useEstimate = true);
 
+    // provided by bel_grid.cc
+    // The first call builds the grid, so must not race with other calls
+    const BelGrid &getBelGrid();
+    std::shared_ptr<const BelGrid> bel_grid;
+
     // --------------------------------------------------------------
     // call after changing hierpath or adding/removing nets and cells
     void fixupHierarchy();
@@ -19,9 +19,17 @@
 
 #include "place_common.h"
 #include <cmath>
+#include <fstream>
+#include <iomanip>
+#include "bel_grid.h"
 #include "log.h"
+#include "timing_graph.h"
 #include "util.h"
 
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
 NEXTPNR_NAMESPACE_BEGIN
 
 // Get the total estimated wirelength for a net
@@ -116,9 +124,9 @@ bool place_single_cell(Context *ctx, CellInfo *cell, bool require_legality)
         if (cell->bel != BelId()) {
             ctx->unbindBel(cell->bel);
         }
-        IdString targetType = cell->type;
-        for (auto bel : ctx->getBels()) {
-            if (ctx->getBelType(bel) == targetType && (!require_legality || ctx->isValidBelForCell(cell, bel))) {
+        const BelGrid &grid = ctx->getBelGrid();
+        for (auto bel : grid.bels_of_type(grid.type_index(cell->type))) {
+            if (!require_legality || ctx->isValidBelForCell(cell, bel)) {
                 if (ctx->checkBelAvail(bel)) {
                     wirelen_t wirelen = get_cell_metric_at_bel(ctx, cell, bel, MetricType::COST);
                     if (iters >= 4)
@@ -537,4 +545,73 @@ bool check_cell_bel_region(const CellInfo *cell, BelId bel)
         return true;
 }
 
+// Default stream formatting switches to scientific notation beyond six significant digits, which turns counts and
+// nanosecond totals into values such as 1.23457e+07. Write integral values exactly and the rest to fixed precision.
+static void write_json_number(std::ostream &out, double value)
+{
+    if (!std::isfinite(value))
+        out << "null";
+    else if (value == std::floor(value) && std::abs(value) < 9e15)
+        out << int64_t(value);
+    else
+        out << std::fixed << std::setprecision(6) << value << std::defaultfloat;
+}
+
+void PlacePerfReport::write(Context *ctx, const std::string &filename) const
+{
+    wirelen_t hpwl = 0;
+    for (auto &net : ctx->nets) {
+        NetInfo *ni = net.second.get();
+        if (ni->driver.cell == nullptr || ni->driver.cell->bel == BelId())
+            continue;
+        Loc drv = ctx->getBelLocation(ni->driver.cell->bel);
+        int x0 = drv.x, x1 = drv.x, y0 = drv.y, y1 = drv.y;
+        for (auto &user : ni->users) {
+            if (user.cell->bel == BelId())
+                continue;
+            Loc loc = ctx->getBelLocation(user.cell->bel);
+            x0 = std::min(x0, loc.x);
+            x1 = std::max(x1, loc.x);
+            y0 = std::min(y0, loc.y);
+            y1 = std::max(y1, loc.y);
+        }
+        hpwl += (x1 - x0) + (y1 - y0);
+    }
+    // Nets are not routed yet, so their delays are the predictDelay estimates
+    TimingGraph timing(ctx);
+    timing.update_all();
+    double crit_path = ctx->getDelayNS(timing.get_critical_path_delay());
+    double peak_rss = 0;
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        peak_rss = usage.ru_maxrss / 1048576.0;
+#else
+        peak_rss = usage.ru_maxrss / 1024.0;
+#endif
+    }
+#endif
+
+    std::ofstream out(filename);
+    if (!out)
+        log_error("Failed to open placement performance report '%s' for writing.\n", filename.c_str());
+    out << "{\n";
+    out << "  \"cells\": " << ctx->cells.size() << ",\n";
+    out << "  \"nets\": " << ctx->nets.size() << ",\n";
+    for (auto &v : values) {
+        out << "  \"" << v.first << "\": ";
+        write_json_number(out, v.second);
+        out << ",\n";
+    }
+    out << "  \"hpwl\": " << hpwl << ",\n";
+    out << "  \"crit_path_ns\": ";
+    write_json_number(out, crit_path);
+    out << ",\n";
+    out << "  \"peak_rss_mb\": ";
+    write_json_number(out, peak_rss);
+    out << "\n";
+    out << "}\n";
+}
+
 NEXTPNR_NAMESPACE_END
@@ -53,6 +53,17 @@ int get_constraints_distance(const Context *ctx, const CellInfo *cell);
 // Check that a Bel is within the region for a cell
 bool check_cell_bel_region(const CellInfo *cell, BelId bel);
 
+// Placement quality and runtime figures, written as a flat JSON object to the file given by --report-place-perf
+// (setting placer/perfReport). Placers add the figures they measure, such as time spent in each stage; write() adds
+// the HPWL of the final placement, the longest path estimated with predictDelay, and peak memory use.
+struct PlacePerfReport
+{
+    std::vector<std::pair<std::string, double>> values;
+
+    void add(const std::string &name, double value) { values.emplace_back(name, value); }
+    void write(Context *ctx, const std::string &filename) const;
+};
+
 NEXTPNR_NAMESPACE_END
 
 #endif
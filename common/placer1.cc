@@ -31,6 +31,7 @@
 #include <limits>
 #include <list>
 #include <map>
+#include <mutex>
 #include <ostream>
 #include <queue>
 #include <set>
@@ -39,9 +40,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include <vector>
+#include "bel_grid.h"
 #include "log.h"
 #include "place_common.h"
+#include "task_pool.h"
+#include "tile_net_counts.h"
 #include "timing.h"
+#include "timing_graph.h"
 #include "util.h"
 
 namespace std {
@@ -74,34 +79,40 @@ class SAPlacer
         }
     };
 
+    struct MoveChangeData;
+    // The state of a run of moves. Serial annealing uses a single one; when annealing in parallel, each window of the
+    // device has its own, and its counts and cost changes are added to the totals once all windows are done
+    struct MoveState
+    {
+        MoveChangeData *mc = nullptr;
+        DeterministicRNG *rng = nullptr;
+        // Index of the window that moves are confined to, or -1 for serial moves
+        int window = -1;
+        int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+        DeterministicRNG window_rng;
+        // Cells in the window, and those whose move was refused as it could conflict with another window
+        std::vector<CellInfo *> cells, blocked;
+
+        int n_move = 0, n_accept = 0;
+        wirelen_t wirelen_delta = 0;
+        double timing_delta = 0;
+        int net_share_delta = 0;
+    };
+
   public:
     SAPlacer(Context *ctx, Placer1Cfg cfg) : ctx(ctx), cfg(cfg)
     {
-        int num_bel_types = 0;
-        for (auto bel : ctx->getBels()) {
-            IdString type = ctx->getBelType(bel);
-            if (bel_types.find(type) == bel_types.end()) {
-                bel_types[type] = std::tuple<int, int>(num_bel_types++, 1);
-            } else {
-                std::get<1>(bel_types.at(type))++;
-            }
-        }
-        for (auto bel : ctx->getBels()) {
-            Loc loc = ctx->getBelLocation(bel);
-            IdString type = ctx->getBelType(bel);
-            int type_idx = std::get<0>(bel_types.at(type));
-            int type_cnt = std::get<1>(bel_types.at(type));
-            if (type_cnt < cfg.minBelsForGridPick)
-                loc.x = loc.y = 0;
-            if (int(fast_bels.size()) < type_idx + 1)
-                fast_bels.resize(type_idx + 1);
-            if (int(fast_bels.at(type_idx).size()) < (loc.x + 1))
-                fast_bels.at(type_idx).resize(loc.x + 1);
-            if (int(fast_bels.at(type_idx).at(loc.x).size()) < (loc.y + 1))
-                fast_bels.at(type_idx).at(loc.x).resize(loc.y + 1);
-            max_x = std::max(max_x, loc.x);
-            max_y = std::max(max_y, loc.y);
-            fast_bels.at(type_idx).at(loc.x).at(loc.y).push_back(bel);
+        grid = &ctx->getBelGrid();
+        // Types with few bels are picked from all bels of the type, rather than by location
+        for (int t = 0; t < grid->num_types(); t++) {
+            if (grid->bels_of_type(t).size() < cfg.minBelsForGridPick)
+                continue;
+            for (int x = 0; x < grid->width; x++)
+                for (int y = 0; y < grid->height; y++)
+                    if (grid->count_at(t, x, y) > 0) {
+                        max_x = std::max(max_x, x);
+                        max_y = std::max(max_y, y);
+                    }
         }
         diameter = std::max(max_x, max_y) + 1;
 
@@ -249,11 +260,13 @@ class SAPlacer
 
         // Invoke timing analysis to obtain criticalities
         if (!cfg.budgetBased)
-            get_criticalities(ctx, &net_crit);
+            update_criticalities();
 
         // Calculate costs after initial placement
         setup_costs();
         moveChange.init(this);
+        serial_state.mc = &moveChange;
+        serial_state.rng = ctx;
         curr_wirelen_cost = total_wirelen_cost();
         curr_timing_cost = total_timing_cost();
         last_wirelen_cost = curr_wirelen_cost;
@@ -267,10 +280,22 @@ class SAPlacer
 
         int n_no_progress = 0;
         temp = refine ? 1e-7 : cfg.startTemp;
+        int num_iters = 0;
+        int64_t total_moves = 0, total_accepts = 0;
+
+        bool parallel = false;
+#ifdef ARCH_XILINX
+        // The xilinx Arch supports binding Bels in different tiles from several threads at once
+        parallel = cfg.parallel && cfg.threads > 1;
+#endif
+        if (parallel)
+            log_info("Annealing windows of %dx%d tiles on %d threads.\n", cfg.parallelWindow, cfg.parallelWindow,
+                     cfg.threads);
 
         // Main simulated annealing loop
         for (int iter = 1;; iter++) {
             n_move = n_accept = 0;
+            num_iters = iter;
             improved = false;
 
             if (iter % 5 == 0 || iter == 1)
@@ -278,24 +303,33 @@ class SAPlacer
                          "%.0f, wirelen = %.0f\n",
                          iter, temp, double(curr_timing_cost), double(curr_wirelen_cost));
 
+            // Windows must be large enough, compared to the move diameter, for most moves to stay inside them; and
+            // cells may only be moved one at a time, so chains are not moved in parallel until legalised
+            bool parallel_iter = parallel && !require_legal && 4 * diameter <= cfg.parallelWindow;
             for (int m = 0; m < 15; ++m) {
-                // Loop through all automatically placed cells
-                for (auto cell : autoplaced) {
+                std::vector<CellInfo *> blocked;
+                if (parallel_iter)
+                    parallel_sweep(autoplaced, m, blocked);
+                // Loop through all automatically placed cells, or those that couldn't be moved in parallel
+                for (auto cell : parallel_iter ? blocked : autoplaced) {
                     // Find another random Bel for this cell
-                    BelId try_bel = random_bel_for_cell(cell);
+                    BelId try_bel = random_bel_for_cell(serial_state, cell);
                     // If valid, try and swap to a new position and see if
                     // the new position is valid/worthwhile
                     if (try_bel != BelId() && try_bel != cell->bel)
-                        try_swap_position(cell, try_bel);
+                        try_swap_position(serial_state, cell, try_bel);
                 }
                 // Also try swapping chains, if applicable
                 for (auto cb : chain_basis) {
                     Loc chain_base_loc = ctx->getBelLocation(cb->bel);
-                    BelId try_base = random_bel_for_cell(cb, chain_base_loc.z);
+                    BelId try_base = random_bel_for_cell(serial_state, cb, chain_base_loc.z);
                     if (try_base != BelId() && try_base != cb->bel)
-                        try_swap_chain(cb, try_base);
+                        try_swap_chain(serial_state, cb, try_base);
                 }
+                merge_state(serial_state);
             }
+            total_moves += n_move;
+            total_accepts += n_accept;
 
             if (ctx->debug) {
                 // Verify correctness of incremental wirelen updates
@@ -386,7 +420,7 @@ class SAPlacer
 
             // Invoke timing analysis to obtain criticalities
             if (!cfg.budgetBased && cfg.timing_driven)
-                get_criticalities(ctx, &net_crit);
+                update_criticalities();
             // Need to rebuild costs after criticalities change
             setup_costs();
             // Reset incremental bounds
@@ -404,7 +438,17 @@ class SAPlacer
         }
 
         auto saplace_end = std::chrono::high_resolution_clock::now();
-        log_info("SA placement time %.02fs\n", std::chrono::duration<float>(saplace_end - saplace_start).count());
+        double sa_time = std::chrono::duration<double>(saplace_end - saplace_start).count();
+        log_info("SA placement time %.02fs\n", sa_time);
+        if (cfg.perf != nullptr) {
+            std::string prefix = refine ? "sa_refine_" : "sa_";
+            cfg.perf->add(prefix + "time", sa_time);
+            cfg.perf->add(prefix + "iterations", num_iters);
+            cfg.perf->add(prefix + "moves", double(total_moves));
+            cfg.perf->add(prefix + "accepted_moves", double(total_accepts));
+            cfg.perf->add(prefix + "moves_per_sec", sa_time > 0 ? total_moves / sa_time : 0);
+            cfg.perf->add(prefix + "wirelen_cost", double(curr_wirelen_cost));
+        }
 
         // Final post-pacement validitiy check
         ctx->yield();
@@ -499,18 +543,29 @@ class SAPlacer
     }
 
     // Attempt a SA position swap, return true on success or false on failure
-    bool try_swap_position(CellInfo *cell, BelId newBel)
+    bool try_swap_position(MoveState &ms, CellInfo *cell, BelId newBel)
     {
         static const double epsilon = 1e-20;
-        moveChange.reset(this);
+        MoveChangeData &mc = *ms.mc;
+        mc.reset(this);
         if (!require_legal && is_constrained(cell))
             return false;
         BelId oldBel = cell->bel;
+        // Bels outside a parallel window may be in use by another window
+        if (ms.window != -1 && !in_window(ms, newBel)) {
+            ms.blocked.push_back(cell);
+            return false;
+        }
         CellInfo *other_cell = ctx->getBoundBelCell(newBel);
         if (!require_legal && other_cell != nullptr &&
             (is_constrained(other_cell) || other_cell->belStrength > STRENGTH_WEAK)) {
             return false;
         }
+        if (ms.window != -1 && (!window_move_ok(ms, cell, newBel) ||
+                                (other_cell != nullptr && !window_move_ok(ms, other_cell, oldBel)))) {
+            ms.blocked.push_back(cell);
+            return false;
+        }
         int old_dist = get_constraints_distance(ctx, cell);
         int new_dist;
         if (other_cell != nullptr)
@@ -519,57 +574,59 @@ class SAPlacer
 
         int net_delta_score = 0;
         if (cfg.netShareWeight > 0)
-            net_delta_score += update_nets_by_tile(cell, ctx->getBelLocation(cell->bel), ctx->getBelLocation(newBel));
+            net_delta_score +=
+                    update_nets_by_tile(ms, cell, ctx->getBelLocation(cell->bel), ctx->getBelLocation(newBel));
 
-        ctx->unbindBel(oldBel);
+        unbind_bel(ms, oldBel);
         if (other_cell != nullptr) {
-            ctx->unbindBel(newBel);
+            unbind_bel(ms, newBel);
         }
 
-        ctx->bindBel(newBel, cell, STRENGTH_WEAK);
+        bind_bel(ms, newBel, cell, STRENGTH_WEAK);
 
         if (other_cell != nullptr) {
-            ctx->bindBel(oldBel, other_cell, STRENGTH_WEAK);
+            bind_bel(ms, oldBel, other_cell, STRENGTH_WEAK);
             if (cfg.netShareWeight > 0)
-                net_delta_score +=
-                        update_nets_by_tile(other_cell, ctx->getBelLocation(newBel), ctx->getBelLocation(oldBel));
+                net_delta_score += update_nets_by_tile(ms, other_cell, ctx->getBelLocation(newBel),
+                                                       ctx->getBelLocation(oldBel));
         }
 
-        add_move_cell(moveChange, cell, oldBel);
+        add_move_cell(mc, cell, oldBel);
 
         if (other_cell != nullptr) {
-            add_move_cell(moveChange, other_cell, newBel);
+            add_move_cell(mc, other_cell, newBel);
         }
 
         if (!ctx->isBelLocationValid(newBel) || ((other_cell != nullptr && !ctx->isBelLocationValid(oldBel)))) {
-            ctx->unbindBel(newBel);
+            unbind_bel(ms, newBel);
             if (other_cell != nullptr)
-                ctx->unbindBel(oldBel);
+                unbind_bel(ms, oldBel);
             goto swap_fail;
         }
 
         // Recalculate metrics for all nets touched by the peturbation
-        compute_cost_changes(moveChange);
+        compute_cost_changes(mc);
 
         new_dist = get_constraints_distance(ctx, cell);
         if (other_cell != nullptr)
             new_dist += get_constraints_distance(ctx, other_cell);
-        delta = lambda * (moveChange.timing_delta / std::max<double>(last_timing_cost, epsilon)) +
-                (1 - lambda) * (double(moveChange.wirelen_delta) / std::max<double>(last_wirelen_cost, epsilon));
+        delta = lambda * (mc.timing_delta / std::max<double>(last_timing_cost, epsilon)) +
+                (1 - lambda) * (double(mc.wirelen_delta) / std::max<double>(last_wirelen_cost, epsilon));
         delta += (cfg.constraintWeight / temp) * (new_dist - old_dist) / last_wirelen_cost;
         if (cfg.netShareWeight > 0)
-            delta += -cfg.netShareWeight * (net_delta_score / std::max<double>(total_net_share, epsilon));
-        n_move++;
+            delta += -cfg.netShareWeight *
+                     (net_delta_score / std::max<double>(total_net_share + ms.net_share_delta, epsilon));
+        ms.n_move++;
         // SA acceptance criterea
-        if (delta < 0 || (temp > 1e-8 && (ctx->rng() / float(0x3fffffff)) <= std::exp(-delta / temp))) {
-            n_accept++;
+        if (delta < 0 || (temp > 1e-8 && (ms.rng->rng() / float(0x3fffffff)) <= std::exp(-delta / temp))) {
+            ms.n_accept++;
         } else {
             if (other_cell != nullptr)
-                ctx->unbindBel(oldBel);
-            ctx->unbindBel(newBel);
+                unbind_bel(ms, oldBel);
+            unbind_bel(ms, newBel);
             goto swap_fail;
         }
-        commit_cost_changes(moveChange);
+        commit_cost_changes(ms);
 #if 0
         log_info("swap %s -> %s\n", cell->name.c_str(ctx), ctx->getBelName(newBel).c_str(ctx));
         if (other_cell != nullptr)
@@ -577,24 +634,76 @@ class SAPlacer
 #endif
         return true;
     swap_fail:
-        ctx->bindBel(oldBel, cell, STRENGTH_WEAK);
+        bind_bel(ms, oldBel, cell, STRENGTH_WEAK);
         if (other_cell != nullptr) {
-            ctx->bindBel(newBel, other_cell, STRENGTH_WEAK);
+            bind_bel(ms, newBel, other_cell, STRENGTH_WEAK);
             if (cfg.netShareWeight > 0)
-                update_nets_by_tile(other_cell, ctx->getBelLocation(oldBel), ctx->getBelLocation(newBel));
+                update_nets_by_tile(ms, other_cell, ctx->getBelLocation(oldBel), ctx->getBelLocation(newBel));
         }
         if (cfg.netShareWeight > 0)
-            update_nets_by_tile(cell, ctx->getBelLocation(newBel), ctx->getBelLocation(oldBel));
+            update_nets_by_tile(ms, cell, ctx->getBelLocation(newBel), ctx->getBelLocation(oldBel));
         return false;
     }
 
+    // Parallel windows bind Bels without updating the UI, which is refreshed once all windows are done
+    void bind_bel(const MoveState &ms, BelId bel, CellInfo *cell, PlaceStrength strength)
+    {
+#ifdef ARCH_XILINX
+        if (ms.window != -1) {
+            ctx->bindBelConcurrent(bel, cell, strength);
+            return;
+        }
+#endif
+        ctx->bindBel(bel, cell, strength);
+    }
+
+    void unbind_bel(const MoveState &ms, BelId bel)
+    {
+#ifdef ARCH_XILINX
+        if (ms.window != -1) {
+            ctx->unbindBelConcurrent(bel);
+            return;
+        }
+#endif
+        ctx->unbindBel(bel);
+    }
+
+    bool in_window(const MoveState &ms, BelId bel)
+    {
+        Loc loc = ctx->getBelLocation(bel);
+        return loc.x >= ms.x0 && loc.x <= ms.x1 && loc.y >= ms.y0 && loc.y <= ms.y1;
+    }
+
+    // Whether a cell inside a parallel window may be moved to a Bel in it, without changing anything that other
+    // windows might use: nets with pins in other windows may only be sinks of the cell, and must keep their bounding
+    // box, so the cell has to be strictly inside it both before and after the move
+    bool window_move_ok(const MoveState &ms, CellInfo *cell, BelId bel)
+    {
+        Loc old_loc = ctx->getBelLocation(cell->bel), new_loc = ctx->getBelLocation(bel);
+        for (const auto &port : cell->ports) {
+            NetInfo *pn = port.second.net;
+            if (pn == nullptr || ignore_net(pn))
+                continue;
+            if (net_window[pn->udata] == ms.window)
+                continue;
+            if (port.second.type != PORT_IN)
+                return false;
+            const BoundingBox &bb = net_bounds[pn->udata];
+            if (old_loc.x <= bb.x0 || old_loc.x >= bb.x1 || old_loc.y <= bb.y0 || old_loc.y >= bb.y1)
+                return false;
+            if (new_loc.x <= bb.x0 || new_loc.x >= bb.x1 || new_loc.y <= bb.y0 || new_loc.y >= bb.y1)
+                return false;
+        }
+        return true;
+    }
+
     inline bool is_constrained(CellInfo *cell)
     {
         return cell->constr_parent != nullptr || !cell->constr_children.empty();
     }
 
     // Swap the Bel of a cell with another, return the original location
-    BelId swap_cell_bels(CellInfo *cell, BelId newBel)
+    BelId swap_cell_bels(MoveState &ms, CellInfo *cell, BelId newBel)
     {
         BelId oldBel = cell->bel;
 #if 0
@@ -608,10 +717,10 @@ class SAPlacer
         if (bound != nullptr) {
             ctx->bindBel(oldBel, bound, is_constrained(bound) ? STRENGTH_STRONG : STRENGTH_WEAK);
             if (cfg.netShareWeight > 0)
-                update_nets_by_tile(bound, ctx->getBelLocation(newBel), ctx->getBelLocation(oldBel));
+                update_nets_by_tile(ms, bound, ctx->getBelLocation(newBel), ctx->getBelLocation(oldBel));
         }
         if (cfg.netShareWeight > 0)
-            update_nets_by_tile(cell, ctx->getBelLocation(oldBel), ctx->getBelLocation(newBel));
+            update_nets_by_tile(ms, cell, ctx->getBelLocation(oldBel), ctx->getBelLocation(newBel));
         return oldBel;
     }
 
@@ -626,15 +735,16 @@ class SAPlacer
     }
 
     // Attempt to swap a chain with a non-chain
-    bool try_swap_chain(CellInfo *cell, BelId newBase)
+    bool try_swap_chain(MoveState &ms, CellInfo *cell, BelId newBase)
     {
+        MoveChangeData &mc = *ms.mc;
         std::vector<std::pair<CellInfo *, Loc>> cell_rel;
         std::unordered_set<IdString> cells;
         std::vector<std::pair<CellInfo *, BelId>> moves_made;
         std::vector<std::pair<CellInfo *, BelId>> dest_bels;
         double delta = 0;
-        int orig_share_cost = total_net_share;
-        moveChange.reset(this);
+        int orig_share_cost = ms.net_share_delta;
+        mc.reset(this);
 #if 0
         if (ctx->debug)
             log_info("finding cells for chain swap %s\n", cell->name.c_str(ctx));
@@ -667,12 +777,12 @@ class SAPlacer
 #endif
         // <cell, oldBel>
         for (const auto &db : dest_bels) {
-            BelId oldBel = swap_cell_bels(db.first, db.second);
+            BelId oldBel = swap_cell_bels(ms, db.first, db.second);
             moves_made.emplace_back(std::make_pair(db.first, oldBel));
             CellInfo *bound = ctx->getBoundBelCell(oldBel);
-            add_move_cell(moveChange, db.first, oldBel);
+            add_move_cell(mc, db.first, oldBel);
             if (bound != nullptr)
-                add_move_cell(moveChange, bound, db.second);
+                add_move_cell(mc, bound, db.second);
         }
         for (const auto &mm : moves_made) {
             if (!ctx->isBelLocationValid(mm.first->bel) || !check_cell_bel_region(mm.first, mm.first->bel))
@@ -683,17 +793,17 @@ class SAPlacer
             if (bound && !check_cell_bel_region(bound, bound->bel))
                 goto swap_fail;
         }
-        compute_cost_changes(moveChange);
-        delta = lambda * (moveChange.timing_delta / last_timing_cost) +
-                (1 - lambda) * (double(moveChange.wirelen_delta) / last_wirelen_cost);
+        compute_cost_changes(mc);
+        delta = lambda * (mc.timing_delta / last_timing_cost) +
+                (1 - lambda) * (double(mc.wirelen_delta) / last_wirelen_cost);
         if (cfg.netShareWeight > 0) {
-            delta +=
-                    cfg.netShareWeight * (orig_share_cost - total_net_share) / std::max<double>(total_net_share, 1e-20);
+            delta += cfg.netShareWeight * (orig_share_cost - ms.net_share_delta) /
+                     std::max<double>(total_net_share + ms.net_share_delta, 1e-20);
         }
-        n_move++;
+        ms.n_move++;
         // SA acceptance criterea
-        if (delta < 0 || (temp > 1e-9 && (ctx->rng() / float(0x3fffffff)) <= std::exp(-delta / temp))) {
-            n_accept++;
+        if (delta < 0 || (temp > 1e-9 && (ms.rng->rng() / float(0x3fffffff)) <= std::exp(-delta / temp))) {
+            ms.n_accept++;
 #if 0
             if (ctx->debug)
                 log_info("accepted chain swap %s\n", cell->name.c_str(ctx));
@@ -701,17 +811,17 @@ class SAPlacer
         } else {
             goto swap_fail;
         }
-        commit_cost_changes(moveChange);
+        commit_cost_changes(ms);
         return true;
     swap_fail:
         for (const auto &entry : boost::adaptors::reverse(moves_made))
-            swap_cell_bels(entry.first, entry.second);
+            swap_cell_bels(ms, entry.first, entry.second);
         return false;
     }
 
     // Find a random Bel of the correct type for a cell, within the specified
     // diameter
-    BelId random_bel_for_cell(CellInfo *cell, int force_z = -1)
+    BelId random_bel_for_cell(MoveState &ms, CellInfo *cell, int force_z = -1)
     {
         IdString targetType = cell->type;
         Loc curr_loc = ctx->getBelLocation(cell->bel);
@@ -731,20 +841,16 @@ class SAPlacer
         }
 
         while (true) {
-            int nx = ctx->rng(2 * dx + 1) + std::max(curr_loc.x - dx, 0);
-            int ny = ctx->rng(2 * dy + 1) + std::max(curr_loc.y - dy, 0);
-            int beltype_idx, beltype_cnt;
-            std::tie(beltype_idx, beltype_cnt) = bel_types.at(targetType);
-            if (beltype_cnt < cfg.minBelsForGridPick)
-                nx = ny = 0;
-            if (nx >= int(fast_bels.at(beltype_idx).size()))
-                continue;
-            if (ny >= int(fast_bels.at(beltype_idx).at(nx).size()))
-                continue;
-            const auto &fb = fast_bels.at(beltype_idx).at(nx).at(ny);
+            int nx = ms.rng->rng(2 * dx + 1) + std::max(curr_loc.x - dx, 0);
+            int ny = ms.rng->rng(2 * dy + 1) + std::max(curr_loc.y - dy, 0);
+            int beltype_idx = grid->type_index(targetType);
+            NPNR_ASSERT(beltype_idx != -1);
+            auto fb = grid->bels_of_type(beltype_idx);
+            if (fb.size() >= cfg.minBelsForGridPick)
+                fb = grid->bels_at(beltype_idx, nx, ny);
             if (fb.size() == 0)
                 continue;
-            BelId bel = fb.at(ctx->rng(int(fb.size())));
+            BelId bel = fb[ms.rng->rng(fb.size())];
             if (force_z != -1) {
                 Loc loc = ctx->getBelLocation(bel);
                 if (loc.z != force_z)
@@ -833,6 +939,18 @@ class SAPlacer
         }
     }
 
+    // Update criticalities, only re-propagating through the cones of nets connected to cells that moved
+    void update_criticalities()
+    {
+        if (timing_graph == nullptr) {
+            timing_graph.reset(new TimingGraph(ctx));
+            timing_graph->update_all();
+        } else {
+            timing_graph->update_placement();
+        }
+        timing_graph->get_criticalities(&net_crit);
+    }
+
     // Set up the cost maps
     void setup_costs()
     {
@@ -937,6 +1055,10 @@ class SAPlacer
             if (ignore_net(pn))
                 continue;
             BoundingBox &curr_bounds = mc.new_net_bounds[pn->udata];
+            // Bounds of nets not yet changed by this move might have been changed by moves made with other state
+            if (mc.already_bounds_changed_x[pn->udata] == MoveChangeData::NO_CHANGE &&
+                mc.already_bounds_changed_y[pn->udata] == MoveChangeData::NO_CHANGE)
+                curr_bounds = net_bounds[pn->udata];
             // Incremental bounding box updates
             // Note that everything other than full updates are applied immediately rather than being queued,
             // so further updates to the same net in the same move are dealt with correctly.
@@ -1109,16 +1231,123 @@ class SAPlacer
         }
     }
 
-    void commit_cost_changes(MoveChangeData &md)
+    void commit_cost_changes(MoveState &ms)
     {
+        MoveChangeData &md = *ms.mc;
         for (const auto &bc : md.bounds_changed_nets_x)
             net_bounds[bc] = md.new_net_bounds[bc];
         for (const auto &bc : md.bounds_changed_nets_y)
             net_bounds[bc] = md.new_net_bounds[bc];
         for (const auto &tc : md.new_arc_costs)
             net_arc_tcost[tc.first.first].at(tc.first.second) = tc.second;
-        curr_wirelen_cost += md.wirelen_delta;
-        curr_timing_cost += md.timing_delta;
+        ms.wirelen_delta += md.wirelen_delta;
+        ms.timing_delta += md.timing_delta;
+    }
+
+    // Add the moves and cost changes made with a move state to the totals
+    void merge_state(MoveState &ms)
+    {
+        n_move += ms.n_move;
+        n_accept += ms.n_accept;
+        curr_wirelen_cost += ms.wirelen_delta;
+        curr_timing_cost += ms.timing_delta;
+        total_net_share += ms.net_share_delta;
+        ms.n_move = ms.n_accept = 0;
+        ms.wirelen_delta = 0;
+        ms.timing_delta = 0;
+        ms.net_share_delta = 0;
+    }
+
+    // Try to move each cell once, splitting the device into a fixed grid of windows that are annealed in parallel, so
+    // that the result doesn't depend on the number of threads. The grid is offset by half a window on odd sweeps, so
+    // that cells near the edge of a window can move across it. Cells whose move was refused are added to blocked, in
+    // window order, to be retried serially
+    void parallel_sweep(const std::vector<CellInfo *> &autoplaced, int sweep, std::vector<CellInfo *> &blocked)
+    {
+        const int size = cfg.parallelWindow;
+        int offset = (sweep % 2) ? size / 2 : 0;
+        int nwx = (ctx->getGridDimX() + offset + size - 1) / size;
+        int nwy = (ctx->getGridDimY() + offset + size - 1) / size;
+        auto window_of = [&](BelId bel) {
+            Loc loc = ctx->getBelLocation(bel);
+            return ((loc.y + offset) / size) * nwx + (loc.x + offset) / size;
+        };
+
+        int num_windows = nwx * nwy;
+        if (int(window_states.size()) < num_windows)
+            window_states.resize(num_windows);
+        for (int w = 0; w < num_windows; w++) {
+            auto &ws = window_states.at(w);
+            ws.window = w;
+            ws.x0 = (w % nwx) * size - offset;
+            ws.x1 = ws.x0 + size - 1;
+            ws.y0 = (w / nwx) * size - offset;
+            ws.y1 = ws.y0 + size - 1;
+            ws.window_rng.rngseed(ctx->rng64());
+            ws.rng = &ws.window_rng;
+            ws.cells.clear();
+            ws.blocked.clear();
+        }
+        for (auto cell : autoplaced)
+            window_states.at(window_of(cell->bel)).cells.push_back(cell);
+
+        // A net may be changed freely by a window if all of its pins are inside it
+        net_window.assign(net_by_udata.size(), -1);
+        for (size_t i = 0; i < net_by_udata.size(); i++) {
+            NetInfo *ni = net_by_udata.at(i);
+            if (ignore_net(ni))
+                continue;
+            int w = window_of(ni->driver.cell->bel);
+            for (auto &usr : ni->users)
+                if (usr.cell->bel == BelId() || window_of(usr.cell->bel) != w) {
+                    w = -1;
+                    break;
+                }
+            net_window.at(i) = w;
+        }
+
+        // Each running window needs its own cost change data, which is handed back once it is done
+        while (int(spare_changes.size()) < cfg.threads) {
+            spare_changes.emplace_back(new MoveChangeData);
+            spare_changes.back()->init(this);
+        }
+        std::vector<MoveChangeData *> free_changes;
+        for (auto &mc : spare_changes)
+            free_changes.push_back(mc.get());
+        std::mutex changes_mutex;
+
+        if (!task_pool)
+            task_pool.reset(new TaskPool(cfg.threads));
+        for (int w = 0; w < num_windows; w++) {
+            MoveState *ws = &window_states.at(w);
+            if (ws->cells.empty())
+                continue;
+            task_pool->add([this, ws, &free_changes, &changes_mutex]() {
+                {
+                    std::lock_guard<std::mutex> lk(changes_mutex);
+                    NPNR_ASSERT(!free_changes.empty());
+                    ws->mc = free_changes.back();
+                    free_changes.pop_back();
+                }
+                for (auto cell : ws->cells) {
+                    BelId try_bel = random_bel_for_cell(*ws, cell);
+                    if (try_bel != BelId() && try_bel != cell->bel)
+                        try_swap_position(*ws, cell, try_bel);
+                }
+                ws->mc->reset(this);
+                std::lock_guard<std::mutex> lk(changes_mutex);
+                free_changes.push_back(ws->mc);
+                ws->mc = nullptr;
+            });
+        }
+        task_pool->run();
+        ctx->refreshUi();
+
+        for (int w = 0; w < num_windows; w++) {
+            auto &ws = window_states.at(w);
+            merge_state(ws);
+            blocked.insert(blocked.end(), ws.blocked.begin(), ws.blocked.end());
+        }
     }
     // Build the cell port -> user index
     void build_port_index()
@@ -1135,55 +1364,47 @@ class SAPlacer
     // Simple routeability driven placement
     const int large_cell_thresh = 50;
     int total_net_share = 0;
-    std::vector<std::vector<std::unordered_map<IdString, int>>> nets_by_tile;
+    // Number of pins of each net in each tile
+    TileNetCounts tile_net_counts;
+
     void setup_nets_by_tile()
     {
         total_net_share = 0;
-        nets_by_tile.resize(max_x + 1, std::vector<std::unordered_map<IdString, int>>(max_y + 1));
+        tile_net_counts.reset(ctx->getGridDimX(), ctx->getGridDimY());
         for (auto cell : sorted(ctx->cells)) {
             CellInfo *ci = cell.second;
             if (int(ci->ports.size()) > large_cell_thresh)
                 continue;
             Loc loc = ctx->getBelLocation(ci->bel);
-            auto &nbt = nets_by_tile.at(loc.x).at(loc.y);
             for (const auto &port : ci->ports) {
                 if (port.second.net == nullptr)
                     continue;
                 if (port.second.net->driver.cell == nullptr || ctx->getBelGlobalBuf(port.second.net->driver.cell->bel))
                     continue;
-                int &s = nbt[port.second.net->name];
-                if (s > 0)
+                if (tile_net_counts.add(loc, port.second.net->udata) > 0)
                     ++total_net_share;
-                ++s;
             }
         }
     }
 
-    int update_nets_by_tile(CellInfo *ci, Loc old_loc, Loc new_loc)
+    int update_nets_by_tile(MoveState &ms, CellInfo *ci, Loc old_loc, Loc new_loc)
     {
         if (int(ci->ports.size()) > large_cell_thresh)
             return 0;
         int loss = 0, gain = 0;
-        auto &nbt_old = nets_by_tile.at(old_loc.x).at(old_loc.y);
-        auto &nbt_new = nets_by_tile.at(new_loc.x).at(new_loc.y);
 
         for (const auto &port : ci->ports) {
             if (port.second.net == nullptr)
                 continue;
             if (port.second.net->driver.cell == nullptr || ctx->getBelGlobalBuf(port.second.net->driver.cell->bel))
                 continue;
-            int &o = nbt_old[port.second.net->name];
-            --o;
-            NPNR_ASSERT(o >= 0);
-            if (o > 0)
+            if (tile_net_counts.remove(old_loc, port.second.net->udata) > 0)
                 ++loss;
-            int &n = nbt_new[port.second.net->name];
-            if (n > 0)
+            if (tile_net_counts.add(new_loc, port.second.net->udata) > 0)
                 ++gain;
-            ++n;
         }
         int delta = gain - loss;
-        total_net_share += delta;
+        ms.net_share_delta += delta;
         return delta;
     }
 
@@ -1205,8 +1426,9 @@ class SAPlacer
     wirelen_t last_wirelen_cost, curr_wirelen_cost;
     double last_timing_cost, curr_timing_cost;
 
-    // Criticality data from timing analysis
+    // Criticality data from timing analysis, kept up to date incrementally between iterations
     NetCriticalityMap net_crit;
+    std::unique_ptr<TimingGraph> timing_graph;
 
     Context *ctx;
     float temp = 10;
@@ -1214,10 +1436,17 @@ class SAPlacer
     float lambda = 0.5;
     bool improved = false;
     int n_move, n_accept;
+    MoveState serial_state;
+    // Parallel annealing state: per window, the cost change data for running windows, and the window each net is
+    // contained in, or -1 for nets that span windows
+    std::vector<MoveState> window_states;
+    std::vector<std::unique_ptr<MoveChangeData>> spare_changes;
+    std::vector<int> net_window;
+    // Threads for the windows, started on the first parallel iteration and kept until placement finishes
+    std::unique_ptr<TaskPool> task_pool;
     int diameter = 35, max_x = 1, max_y = 1;
-    std::unordered_map<IdString, std::tuple<int, int>> bel_types;
+    const BelGrid *grid = nullptr;
     std::unordered_map<IdString, BoundingBox> region_bounds;
-    std::vector<std::vector<std::vector<std::vector<BelId>>>> fast_bels;
     std::unordered_set<BelId> locked_bels;
     std::vector<NetInfo *> net_by_udata;
     std::vector<decltype(NetInfo::udata)> old_udata;
@@ -1238,14 +1467,23 @@ Placer1Cfg::Placer1Cfg(Context *ctx)
     slack_redist_iter = ctx->setting<int>("slack_redist_iter");
     hpwl_scale_x = 1;
     hpwl_scale_y = 1;
+    parallel = ctx->setting<bool>("placer1/parallel", false);
+    parallelWindow = std::max(4, ctx->setting<int>("placer1/parallelWindow", 32));
+    threads = get_thread_count(ctx);
+    perfReport = str_or_default(ctx->settings, ctx->id("placer/perfReport"), "");
 }
 
 bool placer1(Context *ctx, Placer1Cfg cfg)
 {
     try {
+        PlacePerfReport report;
+        if (cfg.perf == nullptr && !cfg.perfReport.empty())
+            cfg.perf = &report;
         SAPlacer placer(ctx, cfg);
         placer.place();
         log_info("Checksum: 0x%08x\n", ctx->checksum());
+        if (cfg.perf == &report)
+            report.write(ctx, cfg.perfReport);
 #ifndef NDEBUG
         ctx->lock();
         ctx->check();
@@ -24,6 +24,8 @@
 
 NEXTPNR_NAMESPACE_BEGIN
 
+struct PlacePerfReport;
+
 struct Placer1Cfg
 {
     Placer1Cfg(Context *ctx);
@@ -35,6 +37,15 @@ struct Placer1Cfg
     bool timing_driven;
     int slack_redist_iter;
     int hpwl_scale_x, hpwl_scale_y;
+    // Anneal a grid of windows of parallelWindow x parallelWindow tiles on several threads, once moves are small
+    // enough (xilinx only). Results depend on the seed, but not on the number of threads
+    bool parallel;
+    int parallelWindow;
+    int threads;
+    // File to write a placement performance report to, if not empty. When placer1 is run as part of another placer,
+    // that placer passes its own report in perf for placer1 to add its figures to
+    std::string perfReport;
+    PlacePerfReport *perf = nullptr;
 };
 
 extern bool placer1(Context *ctx, Placer1Cfg cfg);
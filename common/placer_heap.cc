@@ -38,6 +38,7 @@
 #include <Eigen/IterativeLinearSolvers>
 #include <boost/optional.hpp>
 #include <boost/thread.hpp>
+#include <array>
 #include <chrono>
 #include <deque>
 #include <fstream>
@@ -45,99 +46,27 @@
 #include <queue>
 #include <tuple>
 #include <unordered_map>
+#include "bel_grid.h"
+#include "equation_system.h"
 #include "log.h"
 #include "nextpnr.h"
 #include "place_common.h"
 #include "placer1.h"
+#include "task_pool.h"
 #include "timing.h"
+#include "timing_graph.h"
 #include "util.h"
 NEXTPNR_NAMESPACE_BEGIN
 
-namespace {
-// A simple internal representation for a sparse system of equations Ax = rhs
-// This is designed to decouple the functions that build the matrix to the engine that
-// solves it, and the representation that requires
-template <typename T> struct EquationSystem
-{
-
-    EquationSystem(size_t rows, size_t cols)
-    {
-        A.resize(cols);
-        rhs.resize(rows);
-    }
-
-    // Simple sparse format, easy to convert to CCS for solver
-    std::vector<std::vector<std::pair<int, T>>> A; // col -> (row, x[row, col]) sorted by row
-    std::vector<T> rhs;                            // RHS vector
-    void reset()
-    {
-        for (auto &col : A)
-            col.clear();
-        std::fill(rhs.begin(), rhs.end(), T());
-    }
-
-    void add_coeff(int row, int col, T val)
-    {
-        auto &Ac = A.at(col);
-        // Binary search
-        int b = 0, e = int(Ac.size()) - 1;
-        while (b <= e) {
-            int i = (b + e) / 2;
-            if (Ac.at(i).first == row) {
-                Ac.at(i).second += val;
-                return;
-            }
-            if (Ac.at(i).first > row)
-                e = i - 1;
-            else
-                b = i + 1;
-        }
-        Ac.insert(Ac.begin() + b, std::make_pair(row, val));
-    }
-
-    void add_rhs(int row, T val) { rhs[row] += val; }
-
-    void solve(std::vector<T> &x, float tolerance)
-    {
-        using namespace Eigen;
-        if (x.empty())
-            return;
-        NPNR_ASSERT(x.size() == A.size());
-
-        VectorXd vx(x.size()), vb(rhs.size());
-        SparseMatrix<T> mat(A.size(), A.size());
-
-        std::vector<int> colnnz;
-        for (auto &Ac : A)
-            colnnz.push_back(int(Ac.size()));
-        mat.reserve(colnnz);
-        for (int col = 0; col < int(A.size()); col++) {
-            auto &Ac = A.at(col);
-            for (auto &el : Ac)
-                mat.insert(el.first, col) = el.second;
-        }
-
-        for (int i = 0; i < int(x.size()); i++)
-            vx[i] = x.at(i);
-        for (int i = 0; i < int(rhs.size()); i++)
-            vb[i] = rhs.at(i);
-
-        ConjugateGradient<SparseMatrix<T>, Lower | Upper> solver;
-        solver.setTolerance(tolerance);
-        VectorXd xr = solver.compute(mat).solveWithGuess(vb, vx);
-        for (int i = 0; i < int(x.size()); i++)
-            x.at(i) = xr[i];
-        // for (int i = 0; i < int(x.size()); i++)
-        //    log_info("x[%d] = %f\n", i, x.at(i));
-    }
-};
-
-} // namespace
-
 class HeAPPlacer
 {
   public:
-    HeAPPlacer(Context *ctx, PlacerHeapCfg cfg) : ctx(ctx), cfg(cfg) { Eigen::initParallel(); }
+    HeAPPlacer(Context *ctx, PlacerHeapCfg cfg) : ctx(ctx), cfg(cfg)
+    {
+        Eigen::initParallel();
+        // The x and y systems are usually solved at the same time, so each gets half of the threads
+        Eigen::setNbThreads(std::max(1, cfg.solverThreads / 2));
+    }
 
     bool place()
     {
@@ -148,6 +77,10 @@ class HeAPPlacer
         build_fast_bels();
         seed_placement();
         update_all_chains();
+        if (cfg.slrPartition) {
+            setup_slrs();
+            update_all_chains();
+        }
         wirelen_t hpwl = total_hpwl();
         log_info("Creating initial analytic placement for %d cells, random placement wirelen = %d.\n",
                  int(place_cells.size()), int(hpwl));
@@ -169,7 +102,11 @@ class HeAPPlacer
         wirelen_t solved_hpwl = 0, spread_hpwl = 0, legal_hpwl = 0, best_hpwl = std::numeric_limits<wirelen_t>::max();
         int iter = 0, stalled = 0;
 
+#ifdef ARCH_XILINX
+        Arch::PlacementSnapshot solution;
+#else
         std::vector<std::tuple<CellInfo *, BelId, PlaceStrength>> solution;
+#endif
 
         std::vector<std::unordered_set<IdString>> heap_runs;
         std::unordered_set<IdString> all_celltypes;
@@ -240,6 +177,9 @@ class HeAPPlacer
                 update_all_chains();
 
                 legal_hpwl = total_hpwl();
+                // Criticalities are updated incrementally, so are cheap enough to refresh after every run
+                if (cfg.timing_driven)
+                    update_timing();
                 auto run_stopt = std::chrono::high_resolution_clock::now();
                 log_info("    at iteration #%d, type %s: wirelen solved = %d, spread = %d, legal = %d; time = %.02fs\n",
                          iter + 1, (run.size() > 1 ? "ALL" : run.begin()->c_str(ctx)), int(solved_hpwl),
@@ -247,17 +187,18 @@ class HeAPPlacer
                          std::chrono::duration<double>(run_stopt - run_startt).count());
             }
 
-            if (cfg.timing_driven)
-                get_criticalities(ctx, &net_crit);
-
             if (legal_hpwl < best_hpwl) {
                 best_hpwl = legal_hpwl;
                 stalled = 0;
                 // Save solution
+#ifdef ARCH_XILINX
+                ctx->savePlacement(solution);
+#else
                 solution.clear();
                 for (auto cell : sorted(ctx->cells)) {
                     solution.emplace_back(cell.second, cell.second->bel, cell.second->belStrength);
                 }
+#endif
             } else {
                 ++stalled;
             }
@@ -270,6 +211,9 @@ class HeAPPlacer
         }
 
         // Apply saved solution
+#ifdef ARCH_XILINX
+        ctx->restorePlacement(solution);
+#else
         for (auto &sc : solution) {
             CellInfo *cell = std::get<0>(sc);
             if (cell->bel != BelId())
@@ -282,6 +226,7 @@ class HeAPPlacer
             std::tie(cell, bel, strength) = sc;
             ctx->bindBel(bel, cell, strength);
         }
+#endif
 
         for (auto cell : sorted(ctx->cells)) {
             if (cell.second->bel == BelId())
@@ -298,6 +243,11 @@ class HeAPPlacer
         log_info("  of which solving equations: %.02fs\n", solve_time);
         log_info("  of which spreading cells: %.02fs\n", cl_time);
         log_info("  of which strict legalisation: %.02fs\n", sl_time);
+        if (sl_par_time > 0)
+            log_info("    of which parallel legalisation: %.02fs (%d cells left for serial legalisation)\n", sl_par_time,
+                     sl_deferred);
+        if (cfg.timing_driven)
+            log_info("  of which timing analysis: %.02fs\n", timing_time);
 
         ctx->check();
 
@@ -305,7 +255,22 @@ class HeAPPlacer
         placer1_cfg.hpwl_scale_x = cfg.hpwl_scale_x;
         placer1_cfg.hpwl_scale_y = cfg.hpwl_scale_y;
         placer1_cfg.netShareWeight = cfg.netShareWeight;
+
+        PlacePerfReport report;
+        if (!cfg.perfReport.empty()) {
+            report.add("heap_time", std::chrono::duration<double>(endtt - startt).count());
+            report.add("heap_iterations", iter);
+            report.add("heap_solve_time", solve_time);
+            report.add("heap_spread_time", cl_time);
+            report.add("heap_legalise_time", sl_time);
+            report.add("heap_parallel_legalise_time", sl_par_time);
+            report.add("heap_timing_time", timing_time);
+            report.add("heap_legal_hpwl", double(best_hpwl));
+            placer1_cfg.perf = &report;
+        }
         placer1_refine(ctx, placer1_cfg);
+        if (!cfg.perfReport.empty())
+            report.write(ctx, cfg.perfReport);
 
         return true;
     }
@@ -314,9 +279,27 @@ class HeAPPlacer
     Context *ctx;
     PlacerHeapCfg cfg;
 
+    // Threads for region legalisation and spreading, started when first needed and kept until placement finishes
+    std::unique_ptr<TaskPool> task_pool;
+
+    TaskPool &get_pool()
+    {
+        if (!task_pool)
+            task_pool.reset(new TaskPool(cfg.threads));
+        return *task_pool;
+    }
+
     int max_x = 0, max_y = 0;
-    std::vector<std::vector<std::vector<std::vector<BelId>>>> fast_bels;
-    std::unordered_map<IdString, std::tuple<int, int>> bel_types;
+    const BelGrid *grid = nullptr;
+    // Whether each bel of the grid, and how many bels of each grid slot, were free at the start of placement
+    std::vector<uint8_t> bel_usable;
+    std::vector<int> usable_bels;
+
+    int usable_bels_at(int type, int x, int y) const
+    {
+        int slot = grid->slot_index(type, x, y);
+        return slot == -1 ? 0 : usable_bels.at(slot);
+    }
 
     // For fast handling of heterogeneosity during initial placement without full legalisation,
     // for each Bel type this goes from x or y to the nearest x or y where a Bel of a given type exists
@@ -333,6 +316,31 @@ class HeAPPlacer
 
     std::unordered_map<IdString, BoundingBox> constraint_region_bounds;
 
+    // When partitioning between the SLRs of a multi-die device: the rows of each SLR, the number of SLLs from each to
+    // the next, the SLR of each row, and the SLR assigned to each cell being placed
+    std::vector<BoundingBox> slr_bounds;
+    std::vector<int> slr_sll_count;
+    std::vector<int> slr_of_row;
+    std::unordered_map<IdString, int> cell_slr;
+
+    // The SLR that a cell being placed must stay within, or nullptr if there is none
+    const BoundingBox *get_cell_slr(const CellInfo *cell) const
+    {
+        if (cell_slr.empty())
+            return nullptr;
+        auto fnd = cell_slr.find(cell->name);
+        return fnd == cell_slr.end() ? nullptr : &slr_bounds.at(fnd->second);
+    }
+
+    // The rows that a region containing row y may be spread over
+    std::pair<int, int> spread_rows(int y) const
+    {
+        if (slr_bounds.empty())
+            return std::make_pair(0, max_y);
+        auto &bounds = slr_bounds.at(slr_of_row.at(y));
+        return std::make_pair(bounds.y0, bounds.y1);
+    }
+
     // In some cases, we can't use bindBel because we allow overlap in the earlier stages. So we use this custom
     // structure instead
     struct CellLocation
@@ -350,6 +358,9 @@ class HeAPPlacer
     // The cells in the current equation being solved (a subset of place_cells in some cases, where we only place
     // cells of a certain type)
     std::vector<CellInfo *> solve_cells;
+    EquationSystem<double> es_x, es_y;
+    // Initial positions of the star nodes in the last system built, per axis
+    std::array<std::vector<double>, 2> star_pos;
 
     // For cells in a chain, this is the ultimate root cell of the chain (sometimes this is not constr_parent
     // where chains are within chains
@@ -360,9 +371,27 @@ class HeAPPlacer
     std::unordered_map<IdString, std::pair<int, int>> cell_offsets;
 
     // Performance counting
-    double solve_time = 0, cl_time = 0, sl_time = 0;
+    double solve_time = 0, cl_time = 0, sl_time = 0, sl_par_time = 0, timing_time = 0;
+    int sl_deferred = 0;
 
     NetCriticalityMap net_crit;
+    std::unique_ptr<TimingGraph> timing_graph;
+
+    // Update criticalities for the current legal placement. The first call analyses the whole design, later calls
+    // only the timing cones of cells that moved since.
+    void update_timing()
+    {
+        auto startt = std::chrono::high_resolution_clock::now();
+        if (!timing_graph) {
+            timing_graph.reset(new TimingGraph(ctx));
+            timing_graph->update_all();
+        } else {
+            timing_graph->update_placement();
+        }
+        timing_graph->get_criticalities(&net_crit);
+        auto endt = std::chrono::high_resolution_clock::now();
+        timing_time += std::chrono::duration<double>(endt - startt).count();
+    }
 
     // Place cells with the BEL attribute set to constrain them
     void place_constraints()
@@ -407,67 +436,61 @@ class HeAPPlacer
         ctx->yield();
     }
 
-    // Construct the fast_bels, nearest_row_with_bel and nearest_col_with_bel
+    // Find the usable bels in the shared bel grid, and construct nearest_row_with_bel and nearest_col_with_bel
     void build_fast_bels()
     {
+        grid = &ctx->getBelGrid();
+        // Bels that are already used, for example by constrained cells, are left alone
+        bel_usable.assign(grid->num_bels(), 0);
+        usable_bels.assign(grid->num_slots(), 0);
+        for (int t = 0; t < grid->num_types(); t++)
+            for (int x = 0; x < grid->width; x++)
+                for (int y = 0; y < grid->height; y++) {
+                    auto bels = grid->bels_at(t, x, y);
+                    for (int i = 0; i < bels.size(); i++) {
+                        if (!ctx->checkBelAvail(bels[i]))
+                            continue;
+                        bel_usable.at(BelGrid::bel_index(bels, i)) = 1;
+                        ++usable_bels.at(grid->slot_index(t, x, y));
+                    }
+                    if (usable_bels.at(grid->slot_index(t, x, y)) > 0) {
+                        max_x = std::max(max_x, x);
+                        max_y = std::max(max_y, y);
+                    }
+                }
 
-        int num_bel_types = 0;
-        for (auto bel : ctx->getBels()) {
-            IdString type = ctx->getBelType(bel);
-            if (bel_types.find(type) == bel_types.end()) {
-                bel_types[type] = std::tuple<int, int>(num_bel_types++, 1);
-            } else {
-                std::get<1>(bel_types.at(type))++;
-            }
-        }
-        for (auto bel : ctx->getBels()) {
-            if (!ctx->checkBelAvail(bel))
-                continue;
-            Loc loc = ctx->getBelLocation(bel);
-            IdString type = ctx->getBelType(bel);
-            int type_idx = std::get<0>(bel_types.at(type));
-            if (int(fast_bels.size()) < type_idx + 1)
-                fast_bels.resize(type_idx + 1);
-            if (int(fast_bels.at(type_idx).size()) < (loc.x + 1))
-                fast_bels.at(type_idx).resize(loc.x + 1);
-            if (int(fast_bels.at(type_idx).at(loc.x).size()) < (loc.y + 1))
-                fast_bels.at(type_idx).at(loc.x).resize(loc.y + 1);
-            max_x = std::max(max_x, loc.x);
-            max_y = std::max(max_y, loc.y);
-            fast_bels.at(type_idx).at(loc.x).at(loc.y).push_back(bel);
-        }
-
-        nearest_row_with_bel.resize(num_bel_types, std::vector<int>(max_y + 1, -1));
-        nearest_col_with_bel.resize(num_bel_types, std::vector<int>(max_x + 1, -1));
-        for (auto bel : ctx->getBels()) {
-            if (!ctx->checkBelAvail(bel))
-                continue;
-            Loc loc = ctx->getBelLocation(bel);
-            int type_idx = std::get<0>(bel_types.at(ctx->getBelType(bel)));
-            auto &nr = nearest_row_with_bel.at(type_idx), &nc = nearest_col_with_bel.at(type_idx);
-            // Traverse outwards through nearest_row_with_bel and nearest_col_with_bel, stopping once
-            // another row/col is already recorded as being nearer
-            for (int x = loc.x; x <= max_x; x++) {
-                if (nc.at(x) != -1 && std::abs(loc.x - nc.at(x)) <= (x - loc.x))
-                    break;
-                nc.at(x) = loc.x;
-            }
-            for (int x = loc.x - 1; x >= 0; x--) {
-                if (nc.at(x) != -1 && std::abs(loc.x - nc.at(x)) <= (loc.x - x))
-                    break;
-                nc.at(x) = loc.x;
-            }
-            for (int y = loc.y; y <= max_y; y++) {
-                if (nr.at(y) != -1 && std::abs(loc.y - nr.at(y)) <= (y - loc.y))
-                    break;
-                nr.at(y) = loc.y;
-            }
-            for (int y = loc.y - 1; y >= 0; y--) {
-                if (nr.at(y) != -1 && std::abs(loc.y - nr.at(y)) <= (loc.y - y))
-                    break;
-                nr.at(y) = loc.y;
-            }
-        }
+        nearest_row_with_bel.resize(grid->num_types(), std::vector<int>(max_y + 1, -1));
+        nearest_col_with_bel.resize(grid->num_types(), std::vector<int>(max_x + 1, -1));
+        for (int type_idx = 0; type_idx < grid->num_types(); type_idx++)
+            for (int lx = 0; lx <= max_x; lx++)
+                for (int ly = 0; ly <= max_y; ly++) {
+                    if (usable_bels_at(type_idx, lx, ly) == 0)
+                        continue;
+                    Loc loc(lx, ly, 0);
+                    auto &nr = nearest_row_with_bel.at(type_idx), &nc = nearest_col_with_bel.at(type_idx);
+                    // Traverse outwards through nearest_row_with_bel and nearest_col_with_bel, stopping once
+                    // another row/col is already recorded as being nearer
+                    for (int x = loc.x; x <= max_x; x++) {
+                        if (nc.at(x) != -1 && std::abs(loc.x - nc.at(x)) <= (x - loc.x))
+                            break;
+                        nc.at(x) = loc.x;
+                    }
+                    for (int x = loc.x - 1; x >= 0; x--) {
+                        if (nc.at(x) != -1 && std::abs(loc.x - nc.at(x)) <= (loc.x - x))
+                            break;
+                        nc.at(x) = loc.x;
+                    }
+                    for (int y = loc.y; y <= max_y; y++) {
+                        if (nr.at(y) != -1 && std::abs(loc.y - nr.at(y)) <= (y - loc.y))
+                            break;
+                        nr.at(y) = loc.y;
+                    }
+                    for (int y = loc.y - 1; y >= 0; y--) {
+                        if (nr.at(y) != -1 && std::abs(loc.y - nr.at(y)) <= (loc.y - y))
+                            break;
+                        nr.at(y) = loc.y;
+                    }
+                }
 
         // Determine bounding boxes of region constraints
         for (auto &region : sorted(ctx->region)) {
@@ -498,8 +521,10 @@ class HeAPPlacer
     // Build and solve in one direction
     void build_solve_direction(bool yaxis, int iter)
     {
+        // The system is kept per axis, so that its sparsity pattern can be reused between solves
+        EquationSystem<double> &esx = yaxis ? es_y : es_x;
+        esx.set_solver(cfg.solver);
         for (int i = 0; i < 5; i++) {
-            EquationSystem<double> esx(solve_cells.size(), solve_cells.size());
             build_equations(esx, yaxis, iter);
             solve_equations(esx, yaxis);
         }
@@ -516,6 +541,36 @@ class HeAPPlacer
         return false;
     }
 
+    // Find the SLRs of the device, and partition the cells being placed between them
+    void setup_slrs()
+    {
+#ifdef ARCH_XILINX
+        auto slrs = ctx->getSlrs();
+        for (int i = 0; i < int(slrs.size()); i++) {
+            if (slrs.at(i).y0 > max_y)
+                break;
+            BoundingBox bb;
+            bb.x0 = 0;
+            bb.x1 = max_x;
+            bb.y0 = slrs.at(i).y0;
+            bb.y1 = std::min(max_y, slrs.at(i).y1);
+            slr_bounds.push_back(bb);
+            slr_sll_count.push_back(slrs.at(i).sll_count);
+        }
+#endif
+        if (slr_bounds.size() < 2) {
+            log_info("Device has a single SLR, not partitioning.\n");
+            slr_bounds.clear();
+            slr_sll_count.clear();
+            return;
+        }
+        slr_of_row.resize(max_y + 1);
+        for (int i = 0; i < int(slr_bounds.size()); i++)
+            for (int y = slr_bounds.at(i).y0; y <= slr_bounds.at(i).y1; y++)
+                slr_of_row.at(y) = i;
+        SlrPartitioner(this).run();
+    }
+
     // Build up a random initial placement, without regard to legality
     // FIXME: Are there better approaches to the initial placement (e.g. greedy?)
     void seed_placement()
@@ -630,6 +685,19 @@ class HeAPPlacer
             func(net->users.at(i), i);
     }
 
+    bool use_star_model(const NetInfo *net) const
+    {
+        int pins = int(net->users.size()) + 1;
+        switch (cfg.netModel) {
+        case PlacerHeapCfg::NET_MODEL_STAR:
+            return pins > 2;
+        case PlacerHeapCfg::NET_MODEL_HYBRID:
+            return pins > cfg.starNetThreshold;
+        default:
+            return false;
+        }
+    }
+
     // Build the system of equations for either X or Y
     void build_equations(EquationSystem<double> &es, bool yaxis, int iter = -1)
     {
@@ -639,8 +707,11 @@ class HeAPPlacer
             return yaxis ? cell_locs.at(cell->name).legal_y : cell_locs.at(cell->name).legal_x;
         };
 
-        es.reset();
+        auto &stars = star_pos.at(yaxis ? 1 : 0);
+        stars.clear();
 
+        std::vector<NetInfo *> nets;
+        int num_stars = 0;
         for (auto net : sorted(ctx->nets)) {
             NetInfo *ni = net.second;
             if (ni->driver.cell == nullptr)
@@ -649,6 +720,61 @@ class HeAPPlacer
                 continue;
             if (cell_locs.at(ni->driver.cell->name).global)
                 continue;
+            // Nets without any cell being solved for add nothing to the system
+            bool movable = false;
+            foreach_port(ni, [&](PortRef &port, int user_idx) { movable |= (port.cell->udata != dont_solve); });
+            if (!movable)
+                continue;
+            nets.push_back(ni);
+            if (use_star_model(ni))
+                ++num_stars;
+        }
+        // Star nodes are solved for as extra variables, after the cells
+        es.resize(solve_cells.size() + num_stars, solve_cells.size() + num_stars);
+
+        auto arc_weight = [&](NetInfo *ni, int user_idx, double weight) {
+            if (user_idx != -1 && net_crit.count(ni->name)) {
+                auto &nc = net_crit.at(ni->name);
+                if (user_idx < int(nc.criticality.size()))
+                    weight *= (1.0 + cfg.timingWeight * std::pow(nc.criticality.at(user_idx), cfg.criticalityExponent));
+            }
+            return weight;
+        };
+
+        for (auto ni : nets) {
+            if (use_star_model(ni)) {
+                // Connect every pin to a star node, starting from the mean pin position. The weights linearise the
+                // distance to the star node around the current placement, as bound-to-bound does for the bounds.
+                double star = 0;
+                foreach_port(ni, [&](PortRef &port, int user_idx) { star += cell_pos(port.cell); });
+                star /= (ni->users.size() + 1);
+                int star_row = int(solve_cells.size() + stars.size());
+                stars.push_back(star);
+                foreach_port(ni, [&](PortRef &port, int user_idx) {
+                    int pos = cell_pos(port.cell);
+                    double weight = arc_weight(
+                            ni, user_idx,
+                            2.0 / ((ni->users.size() + 1) *
+                                   std::max<double>(1, (yaxis ? cfg.hpwl_scale_y : cfg.hpwl_scale_x) *
+                                                               std::abs(pos - star))));
+                    double offset = 0;
+                    if (cell_offsets.count(port.cell->name))
+                        offset = yaxis ? cell_offsets.at(port.cell->name).second
+                                       : cell_offsets.at(port.cell->name).first;
+                    es.add_coeff(star_row, star_row, weight);
+                    es.add_rhs(star_row, offset * weight);
+                    if (port.cell->udata != dont_solve) {
+                        int row = port.cell->udata;
+                        es.add_coeff(row, row, weight);
+                        es.add_coeff(row, star_row, -weight);
+                        es.add_coeff(star_row, row, -weight);
+                        es.add_rhs(row, -offset * weight);
+                    } else {
+                        es.add_rhs(star_row, pos * weight);
+                    }
+                });
+                continue;
+            }
             // Find the bounds of the net in this axis, and the ports that correspond to these bounds
             PortRef *lbport = nullptr, *ubport = nullptr;
             int lbpos = std::numeric_limits<int>::max(), ubpos = std::numeric_limits<int>::min();
@@ -690,16 +816,10 @@ class HeAPPlacer
                     if (other == &port)
                         return;
                     int o_pos = cell_pos(other->cell);
-                    double weight = 1.0 / (ni->users.size() *
-                                           std::max<double>(1, (yaxis ? cfg.hpwl_scale_y : cfg.hpwl_scale_x) *
-                                                                       std::abs(o_pos - this_pos)));
-
-                    if (user_idx != -1 && net_crit.count(ni->name)) {
-                        auto &nc = net_crit.at(ni->name);
-                        if (user_idx < int(nc.criticality.size()))
-                            weight *= (1.0 + cfg.timingWeight *
-                                                     std::pow(nc.criticality.at(user_idx), cfg.criticalityExponent));
-                    }
+                    double weight = arc_weight(
+                            ni, user_idx,
+                            1.0 / (ni->users.size() * std::max<double>(1, (yaxis ? cfg.hpwl_scale_y : cfg.hpwl_scale_x) *
+                                                                                  std::abs(o_pos - this_pos))));
 
                     // If cell 0 is not fixed, it will stamp +w on its equation and -w on the other end's equation,
                     // if the other end isn't fixed
@@ -735,14 +855,19 @@ class HeAPPlacer
         auto cell_pos = [&](CellInfo *cell) { return yaxis ? cell_locs.at(cell->name).y : cell_locs.at(cell->name).x; };
         std::vector<double> vals;
         std::transform(solve_cells.begin(), solve_cells.end(), std::back_inserter(vals), cell_pos);
+        auto &stars = star_pos.at(yaxis ? 1 : 0);
+        vals.insert(vals.end(), stars.begin(), stars.end());
         es.solve(vals, cfg.solverTolerance);
-        for (size_t i = 0; i < vals.size(); i++)
+        for (size_t i = 0; i < solve_cells.size(); i++)
             if (yaxis) {
                 cell_locs.at(solve_cells.at(i)->name).rawy = vals.at(i);
                 cell_locs.at(solve_cells.at(i)->name).y = std::min(max_y, std::max(0, int(vals.at(i))));
                 if (solve_cells.at(i)->region != nullptr)
                     cell_locs.at(solve_cells.at(i)->name).y =
                             limit_to_reg(solve_cells.at(i)->region, cell_locs.at(solve_cells.at(i)->name).y, true);
+                else if (const BoundingBox *slr = get_cell_slr(solve_cells.at(i)))
+                    cell_locs.at(solve_cells.at(i)->name).y =
+                            std::max(slr->y0, std::min(slr->y1, cell_locs.at(solve_cells.at(i)->name).y));
             } else {
                 cell_locs.at(solve_cells.at(i)->name).rawx = vals.at(i);
                 cell_locs.at(solve_cells.at(i)->name).x = std::min(max_x, std::max(0, int(vals.at(i))));
@@ -776,6 +901,56 @@ class HeAPPlacer
         return hpwl;
     }
 
+    // State of strict legalisation within a rectangular region of the device. Regions legalised in parallel only
+    // touch Bels within their own bounds, deferring cells they can't place to a final serial pass
+    struct LegaliseRegion
+    {
+        int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+        bool is_mt = false;
+        DeterministicRNG rng;
+        std::priority_queue<std::pair<int, IdString>> remaining;
+        int num_cells = 0;
+        // Locations of cells driving those being legalised, for the wirelength heuristic. In parallel regions, this
+        // is a snapshot, as cell_locs is being updated by other regions
+        const std::unordered_map<IdString, CellLocation> *driver_locs = nullptr;
+        std::vector<IdString> deferred;
+    };
+
+    int legalise_rng(LegaliseRegion &lr, int n) { return lr.is_mt ? lr.rng.rng(n) : ctx->rng(n); }
+
+    int get_chain_size(IdString cell) const
+    {
+        auto fnd = chain_size.find(cell);
+        return fnd == chain_size.end() ? 0 : fnd->second;
+    }
+
+    CellLocation &legalise_loc(LegaliseRegion &lr, IdString cell)
+    {
+        return lr.is_mt ? cell_locs.at(cell) : cell_locs[cell];
+    }
+
+    void legalise_bind(LegaliseRegion &lr, BelId bel, CellInfo *cell, PlaceStrength strength)
+    {
+#ifdef ARCH_XILINX
+        if (lr.is_mt) {
+            ctx->bindBelConcurrent(bel, cell, strength);
+            return;
+        }
+#endif
+        ctx->bindBel(bel, cell, strength);
+    }
+
+    void legalise_unbind(LegaliseRegion &lr, BelId bel)
+    {
+#ifdef ARCH_XILINX
+        if (lr.is_mt) {
+            ctx->unbindBelConcurrent(bel);
+            return;
+        }
+#endif
+        ctx->unbindBel(bel);
+    }
+
     // Strict placement legalisation, performed after the initial HeAP spreading
     void legalise_placement_strict(bool require_validity = false)
     {
@@ -791,10 +966,92 @@ class HeAPPlacer
 
         // At the moment we don't follow the full HeAP algorithm using cuts for legalisation, instead using
         // the simple greedy largest-macro-first approach.
-        std::priority_queue<std::pair<int, IdString>> remaining;
+        LegaliseRegion device;
+        device.x1 = max_x;
+        device.y1 = max_y;
+        device.num_cells = int(solve_cells.size());
+        device.driver_locs = &cell_locs;
+        bool parallel = false;
+#ifdef ARCH_XILINX
+        // The xilinx Arch supports binding Bels in different tiles from several threads at once
+        parallel = cfg.parallelLegalise && cfg.threads > 1;
+#endif
+        if (parallel) {
+            legalise_parallel(device, require_validity);
+        } else {
+            for (auto cell : solve_cells)
+                device.remaining.emplace(get_chain_size(cell->name), cell->name);
+        }
+        legalise_region(device, require_validity);
+
+        auto endt = std::chrono::high_resolution_clock::now();
+        sl_time += std::chrono::duration<float>(endt - startt).count();
+    }
+
+    // Legalise cells in a fixed grid of regions in parallel, so that the result doesn't depend on the number of
+    // threads. Cells that couldn't be placed within their region are added to the device-wide queue
+    void legalise_parallel(LegaliseRegion &device, bool require_validity)
+    {
+        auto startt = std::chrono::high_resolution_clock::now();
+        const int region_size = 32;
+        int width = max_x + 1, height = max_y + 1;
+        int nrx = std::max(1, width / region_size), nry = std::max(1, height / region_size);
+        // Region i along an axis of length len, split n ways, starts at i * len / n
+        auto region_of = [](int pos, int len, int n) {
+            int i = std::min(n - 1, std::max(0, pos) * n / len);
+            while (i > 0 && pos < i * len / n)
+                --i;
+            while (i < n - 1 && pos >= (i + 1) * len / n)
+                ++i;
+            return i;
+        };
+        std::unordered_map<IdString, CellLocation> driver_locs = cell_locs;
+        std::vector<std::unique_ptr<LegaliseRegion>> regions;
+        for (int ry = 0; ry < nry; ry++) {
+            for (int rx = 0; rx < nrx; rx++) {
+                regions.emplace_back(new LegaliseRegion);
+                auto &lr = *regions.back();
+                lr.x0 = rx * width / nrx;
+                lr.x1 = (rx + 1) * width / nrx - 1;
+                lr.y0 = ry * height / nry;
+                lr.y1 = (ry + 1) * height / nry - 1;
+                lr.is_mt = true;
+                lr.rng.rngseed(ctx->rng64());
+                lr.driver_locs = &driver_locs;
+            }
+        }
         for (auto cell : solve_cells) {
-            remaining.emplace(chain_size[cell->name], cell->name);
+            auto &loc = cell_locs.at(cell->name);
+            auto &lr = *regions.at(region_of(loc.y, height, nry) * nrx + region_of(loc.x, width, nrx));
+            lr.remaining.emplace(get_chain_size(cell->name), cell->name);
+            ++lr.num_cells;
+        }
+
+        TaskPool &pool = get_pool();
+        for (auto &r : regions) {
+            LegaliseRegion *lr = r.get();
+            if (!lr->remaining.empty())
+                pool.add([this, lr, require_validity]() { legalise_region(*lr, require_validity); });
+        }
+        pool.run();
+        ctx->refreshUi();
+
+        int deferred = 0;
+        for (auto &r : regions) {
+            for (auto cell : r->deferred)
+                device.remaining.emplace(get_chain_size(cell), cell);
+            deferred += int(r->deferred.size());
         }
+        auto endt = std::chrono::high_resolution_clock::now();
+        sl_par_time += std::chrono::duration<float>(endt - startt).count();
+        sl_deferred += deferred;
+    }
+
+    void legalise_region(LegaliseRegion &lr, bool require_validity)
+    {
+        auto &remaining = lr.remaining;
+        // Parallel regions may only search within their own bounds
+        int max_radius = lr.is_mt ? std::max(lr.x1 - lr.x0, lr.y1 - lr.y0) : std::max(max_x, max_y);
         int ripup_radius = 2;
         int total_iters = 0;
         int total_iters_noreset = 0;
@@ -807,8 +1064,8 @@ class HeAPPlacer
             if (ci->bel != BelId())
                 continue;
             // log_info("   Legalising %s (%s)\n", top.second.c_str(ctx), ci->type.c_str(ctx));
-            int bt = std::get<0>(bel_types.at(ci->type));
-            auto &fb = fast_bels.at(bt);
+            int bt = grid->type_index(ci->type);
+            const BoundingBox *slr = get_cell_slr(ci);
             int radius = 0;
             int iter = 0;
             int iter_at_radius = 0;
@@ -818,121 +1075,135 @@ class HeAPPlacer
 
             total_iters++;
             total_iters_noreset++;
-            if (total_iters > int(solve_cells.size())) {
+            if (total_iters > lr.num_cells) {
                 total_iters = 0;
-                ripup_radius = std::max(std::max(max_x, max_y), ripup_radius * 2);
+                ripup_radius = std::max(max_radius, ripup_radius * 2);
             }
 
             if (total_iters_noreset > std::max(5000, 8 * int(ctx->cells.size()))) {
+                if (lr.is_mt) {
+                    lr.deferred.push_back(ci->name);
+                    while (!remaining.empty()) {
+                        lr.deferred.push_back(remaining.top().second);
+                        remaining.pop();
+                    }
+                    break;
+                }
                 log_error("Unable to find legal placement for all cells, design is probably at utilisation limit.\n");
             }
 
+            int iter_at_max_radius = 0;
             while (!placed) {
 
                 // Set a conservative timeout
                 if (iter > std::max(10000, 3 * int(ctx->cells.size())))
                     log_error("Unable to find legal placement for cell '%s', check constraints and utilisation.\n",
                               ctx->nameOf(ci));
+                // Give up on cells that don't fit in a parallel region, for the serial pass to deal with
+                if (lr.is_mt && radius >= max_radius && ++iter_at_max_radius > 20 * (max_radius + 1)) {
+                    lr.deferred.push_back(ci->name);
+                    break;
+                }
 
                 int rx = radius, ry = radius;
 
                 if (ci->region != nullptr) {
-                    rx = std::min(radius, (constraint_region_bounds[ci->region->name].x1 -
-                                           constraint_region_bounds[ci->region->name].x0) /
-                                                          2 +
-                                                  1);
-                    ry = std::min(radius, (constraint_region_bounds[ci->region->name].y1 -
-                                           constraint_region_bounds[ci->region->name].y0) /
-                                                          2 +
-                                                  1);
+                    auto &reg_bounds = constraint_region_bounds.at(ci->region->name);
+                    rx = std::min(radius, (reg_bounds.x1 - reg_bounds.x0) / 2 + 1);
+                    ry = std::min(radius, (reg_bounds.y1 - reg_bounds.y0) / 2 + 1);
                 }
 
-                int nx = ctx->rng(2 * rx + 1) + std::max(cell_locs.at(ci->name).x - rx, 0);
-                int ny = ctx->rng(2 * ry + 1) + std::max(cell_locs.at(ci->name).y - ry, 0);
+                int cx = cell_locs.at(ci->name).x, cy = cell_locs.at(ci->name).y;
+                int nx, ny;
+                if (lr.is_mt) {
+                    int nx0 = std::max(cx - rx, lr.x0), nx1 = std::max(nx0, std::min(cx + rx, lr.x1));
+                    int ny0 = std::max(cy - ry, lr.y0), ny1 = std::max(ny0, std::min(cy + ry, lr.y1));
+                    nx = nx0 + legalise_rng(lr, nx1 - nx0 + 1);
+                    ny = ny0 + legalise_rng(lr, ny1 - ny0 + 1);
+                } else {
+                    nx = ctx->rng(2 * rx + 1) + std::max(cx - rx, 0);
+                    ny = ctx->rng(2 * ry + 1) + std::max(cy - ry, 0);
+                }
 
                 iter++;
                 iter_at_radius++;
                 if (iter >= (10 * (radius + 1))) {
-                    radius = std::min(std::max(max_x, max_y), radius + 1);
-                    while (radius < std::max(max_x, max_y)) {
-                        for (int x = std::max(0, cell_locs.at(ci->name).x - radius);
-                             x <= std::min(max_x, cell_locs.at(ci->name).x + radius); x++) {
-                            if (x >= int(fb.size()))
-                                break;
-                            for (int y = std::max(0, cell_locs.at(ci->name).y - radius);
-                                 y <= std::min(max_y, cell_locs.at(ci->name).y + radius); y++) {
-                                if (y >= int(fb.at(x).size()))
-                                    break;
-                                if (fb.at(x).at(y).size() > 0)
+                    radius = std::min(max_radius, radius + 1);
+                    while (radius < max_radius) {
+                        for (int x = std::max(lr.x0, cx - radius); x <= std::min(lr.x1, cx + radius); x++) {
+                            for (int y = std::max(lr.y0, cy - radius); y <= std::min(lr.y1, cy + radius); y++) {
+                                if (usable_bels_at(bt, x, y) > 0)
                                     goto notempty;
                             }
                         }
-                        radius = std::min(std::max(max_x, max_y), radius + 1);
+                        radius = std::min(max_radius, radius + 1);
                     }
                 notempty:
                     iter_at_radius = 0;
                     iter = 0;
                 }
-                if (nx < 0 || nx > max_x)
+                if (nx < lr.x0 || nx > lr.x1)
                     continue;
-                if (ny < 0 || ny > max_y)
+                if (ny < lr.y0 || ny > lr.y1)
+                    continue;
+                if (slr != nullptr && (ny < slr->y0 || ny > slr->y1))
                     continue;
 
                 // ny = nearest_row_with_bel.at(bt).at(ny);
                 // nx = nearest_col_with_bel.at(bt).at(nx);
 
-                if (nx >= int(fb.size()))
-                    continue;
-                if (ny >= int(fb.at(nx).size()))
-                    continue;
-                if (fb.at(nx).at(ny).empty())
+                if (usable_bels_at(bt, nx, ny) == 0)
                     continue;
+                auto bels = grid->bels_at(bt, nx, ny);
 
                 int need_to_explore = 2 * radius;
 
                 if (iter_at_radius >= need_to_explore && bestBel != BelId()) {
                     CellInfo *bound = ctx->getBoundBelCell(bestBel);
                     if (bound != nullptr) {
-                        ctx->unbindBel(bound->bel);
-                        remaining.emplace(chain_size[bound->name], bound->name);
+                        legalise_unbind(lr, bound->bel);
+                        remaining.emplace(get_chain_size(bound->name), bound->name);
                     }
-                    ctx->bindBel(bestBel, ci, STRENGTH_WEAK);
+                    legalise_bind(lr, bestBel, ci, STRENGTH_WEAK);
                     placed = true;
                     Loc loc = ctx->getBelLocation(bestBel);
-                    cell_locs[ci->name].x = loc.x;
-                    cell_locs[ci->name].y = loc.y;
+                    legalise_loc(lr, ci->name).x = loc.x;
+                    legalise_loc(lr, ci->name).y = loc.y;
                     break;
                 }
 
                 if (ci->constr_children.empty() && !ci->constr_abs_z) {
-                    for (auto sz : fb.at(nx).at(ny)) {
+                    for (int i = 0; i < bels.size(); i++) {
+                        if (!bel_usable.at(BelGrid::bel_index(bels, i)))
+                            continue;
+                        BelId sz = bels[i];
                         if (ci->region != nullptr && ci->region->constr_bels && !ci->region->bels.count(sz))
                             continue;
-                        if (ctx->checkBelAvail(sz) || (radius > ripup_radius || ctx->rng(20000) < 10)) {
+                        if (ctx->checkBelAvail(sz) || (radius > ripup_radius || legalise_rng(lr, 20000) < 10)) {
                             CellInfo *bound = ctx->getBoundBelCell(sz);
                             if (bound != nullptr) {
                                 if (bound->constr_parent != nullptr || !bound->constr_children.empty() ||
                                     bound->constr_abs_z)
                                     continue;
-                                ctx->unbindBel(bound->bel);
+                                legalise_unbind(lr, bound->bel);
                             }
-                            ctx->bindBel(sz, ci, STRENGTH_WEAK);
+                            legalise_bind(lr, sz, ci, STRENGTH_WEAK);
                             if (require_validity && !ctx->isBelLocationValid(sz)) {
-                                ctx->unbindBel(sz);
+                                legalise_unbind(lr, sz);
                                 if (bound != nullptr)
-                                    ctx->bindBel(sz, bound, STRENGTH_WEAK);
+                                    legalise_bind(lr, sz, bound, STRENGTH_WEAK);
                             } else if (iter_at_radius < need_to_explore) {
-                                ctx->unbindBel(sz);
+                                legalise_unbind(lr, sz);
                                 if (bound != nullptr)
-                                    ctx->bindBel(sz, bound, STRENGTH_WEAK);
+                                    legalise_bind(lr, sz, bound, STRENGTH_WEAK);
                                 int input_len = 0;
                                 for (auto &port : ci->ports) {
                                     auto &p = port.second;
                                     if (p.type != PORT_IN || p.net == nullptr || p.net->driver.cell == nullptr)
                                         continue;
                                     CellInfo *drv = p.net->driver.cell;
-                                    auto drv_loc = cell_locs.find(drv->name);
-                                    if (drv_loc == cell_locs.end())
+                                    auto drv_loc = lr.driver_locs->find(drv->name);
+                                    if (drv_loc == lr.driver_locs->end())
                                         continue;
                                     if (drv_loc->second.global)
                                         continue;
@@ -945,17 +1216,20 @@ class HeAPPlacer
                                 break;
                             } else {
                                 if (bound != nullptr)
-                                    remaining.emplace(chain_size[bound->name], bound->name);
+                                    remaining.emplace(get_chain_size(bound->name), bound->name);
                                 Loc loc = ctx->getBelLocation(sz);
-                                cell_locs[ci->name].x = loc.x;
-                                cell_locs[ci->name].y = loc.y;
+                                legalise_loc(lr, ci->name).x = loc.x;
+                                legalise_loc(lr, ci->name).y = loc.y;
                                 placed = true;
                                 break;
                             }
                         }
                     }
                 } else {
-                    for (auto sz : fb.at(nx).at(ny)) {
+                    for (int i = 0; i < bels.size(); i++) {
+                        if (!bel_usable.at(BelGrid::bel_index(bels, i)))
+                            continue;
+                        BelId sz = bels[i];
                         Loc loc = ctx->getBelLocation(sz);
                         if (ci->constr_abs_z && loc.z != ci->constr_z)
                             continue;
@@ -968,6 +1242,8 @@ class HeAPPlacer
                             NPNR_ASSERT(vc->bel == BelId());
                             Loc ploc = visit.front().second;
                             visit.pop();
+                            if (ploc.x < lr.x0 || ploc.x > lr.x1 || ploc.y < lr.y0 || ploc.y > lr.y1)
+                                goto fail;
                             BelId target = ctx->getBelByLocation(ploc);
                             if (vc->region != nullptr && vc->region->constr_bels && !vc->region->bels.count(target))
                                 goto fail;
@@ -996,8 +1272,8 @@ class HeAPPlacer
                         for (auto &target : targets) {
                             CellInfo *bound = ctx->getBoundBelCell(target.second);
                             if (bound != nullptr)
-                                ctx->unbindBel(target.second);
-                            ctx->bindBel(target.second, target.first, STRENGTH_STRONG);
+                                legalise_unbind(lr, target.second);
+                            legalise_bind(lr, target.second, target.first, STRENGTH_STRONG);
                             swaps_made.emplace_back(target.second, bound);
                         }
 
@@ -1009,21 +1285,21 @@ class HeAPPlacer
                         if (false) {
                         fail:
                             for (auto &swap : swaps_made) {
-                                ctx->unbindBel(swap.first);
+                                legalise_unbind(lr, swap.first);
                                 if (swap.second != nullptr)
-                                    ctx->bindBel(swap.first, swap.second, STRENGTH_WEAK);
+                                    legalise_bind(lr, swap.first, swap.second, STRENGTH_WEAK);
                             }
                             continue;
                         }
                         for (auto &target : targets) {
                             Loc loc = ctx->getBelLocation(target.second);
-                            cell_locs[target.first->name].x = loc.x;
-                            cell_locs[target.first->name].y = loc.y;
+                            legalise_loc(lr, target.first->name).x = loc.x;
+                            legalise_loc(lr, target.first->name).y = loc.y;
                             // log_info("%s %d %d %d\n", target.first->name.c_str(ctx), loc.x, loc.y, loc.z);
                         }
                         for (auto &swap : swaps_made) {
                             if (swap.second != nullptr)
-                                remaining.emplace(chain_size[swap.second->name], swap.second->name);
+                                remaining.emplace(get_chain_size(swap.second->name), swap.second->name);
                         }
 
                         placed = true;
@@ -1032,8 +1308,6 @@ class HeAPPlacer
                 }
             }
         }
-        auto endt = std::chrono::high_resolution_clock::now();
-        sl_time += std::chrono::duration<float>(endt - startt).count();
     }
     // Implementation of the cut-based spreading as described in the HeAP/SimPL papers
 
@@ -1041,8 +1315,9 @@ class HeAPPlacer
     {
         if (reg == nullptr)
             return val;
-        int limit_low = dir ? constraint_region_bounds[reg->name].y0 : constraint_region_bounds[reg->name].x0;
-        int limit_high = dir ? constraint_region_bounds[reg->name].y1 : constraint_region_bounds[reg->name].x1;
+        auto &bounds = constraint_region_bounds.at(reg->name);
+        int limit_low = dir ? bounds.y0 : bounds.x0;
+        int limit_high = dir ? bounds.y1 : bounds.x1;
         return std::max<T>(std::min<T>(val, limit_high), limit_low);
     }
 
@@ -1079,8 +1354,7 @@ class HeAPPlacer
             int idx = 0;
             for (IdString type : sorted(beltype)) {
                 type_index[type] = idx;
-                fb.emplace_back(p->bel_types.count(type) ? &(p->fast_bels.at(std::get<0>(p->bel_types.at(type))))
-                                                         : nullptr);
+                grid_type.push_back(p->grid->type_index(type));
                 ++idx;
             }
         }
@@ -1099,13 +1373,16 @@ class HeAPPlacer
 #endif
             }
             expand_regions();
-            std::queue<std::pair<int, bool>> workqueue;
 #if 0
             std::vector<std::pair<double, double>> orig;
             if (ctx->debug)
                 for (auto c : p->solve_cells)
                     orig.emplace_back(p->cell_locs[c->name].rawx, p->cell_locs[c->name].rawy);
 #endif
+            // The regions are disjoint, and cutting one only moves the cells inside it, so each region and every
+            // part cut from it can be spread as a separate task. The result does not depend on the order in which
+            // tasks run, and so matches a serial run whatever the number of threads.
+            TaskPool &pool = p->get_pool();
             for (auto &r : regions) {
                 if (merged_regions.count(r.id))
                     continue;
@@ -1116,29 +1393,10 @@ class HeAPPlacer
                 }
 
 #endif
-                workqueue.emplace(r.id, false);
-                // cut_region(r, false);
-            }
-            while (!workqueue.empty()) {
-                auto front = workqueue.front();
-                workqueue.pop();
-                auto &r = regions.at(front.first);
-                if (std::all_of(r.cells.begin(), r.cells.end(), [](int x) { return x == 0; }))
-                    continue;
-                auto res = cut_region(r, front.second);
-                if (res) {
-                    workqueue.emplace(res->first, !front.second);
-                    workqueue.emplace(res->second, !front.second);
-                } else {
-                    // Try the other dir, in case stuck in one direction only
-                    auto res2 = cut_region(r, !front.second);
-                    if (res2) {
-                        // log_info("RETRY SUCCESS\n");
-                        workqueue.emplace(res2->first, front.second);
-                        workqueue.emplace(res2->second, front.second);
-                    }
-                }
+                SpreaderRegion root = r;
+                pool.add([this, &pool, root]() { spread_region(pool, root, false); });
             }
+            pool.run();
 #if 0
             if (ctx->debug) {
                 std::ofstream sp("spread" + std::to_string(seq) + ".csv");
@@ -1172,7 +1430,8 @@ class HeAPPlacer
         std::vector<std::vector<ChainExtent>> chaines;
         std::map<IdString, ChainExtent> cell_extents;
 
-        std::vector<std::vector<std::vector<std::vector<BelId>>> *> fb;
+        // Index in the bel grid of each type, or -1 if there are no bels of the type
+        std::vector<int> grid_type;
 
         std::vector<SpreaderRegion> regions;
         std::unordered_set<int> merged_regions;
@@ -1181,12 +1440,7 @@ class HeAPPlacer
 
         int occ_at(int x, int y, int type) { return occupancy.at(x).at(y).at(type); }
 
-        int bels_at(int x, int y, int type)
-        {
-            if (fb.at(type) == nullptr || x >= int(fb.at(type)->size()) || y >= int(fb.at(type)->at(x).size()))
-                return 0;
-            return int(fb.at(type)->at(x).at(y).size());
-        }
+        int bels_at(int x, int y, int type) { return p->usable_bels_at(grid_type.at(type), x, y); }
 
         void init()
         {
@@ -1331,6 +1585,8 @@ class HeAPPlacer
                     reg.id = id;
                     reg.x0 = reg.x1 = x;
                     reg.y0 = reg.y1 = y;
+                    // When partitioning between SLRs, the cells in each stay within its rows
+                    auto rows = p->spread_rows(y);
                     for (size_t t = 0; t < beltype.size(); t++) {
                         reg.bels.push_back(bels_at(x, y, t));
                         reg.cells.push_back(occ_at(x, y, t));
@@ -1363,7 +1619,7 @@ class HeAPPlacer
                             }
                         }
 
-                        if (reg.y1 < p->max_y) {
+                        if (reg.y1 < rows.second) {
                             bool over_occ_y = false;
                             for (int x1 = reg.x0; x1 <= reg.x1; x1++) {
                                 for (size_t t = 0; t < beltype.size(); t++) {
@@ -1399,6 +1655,7 @@ class HeAPPlacer
                 if (merged_regions.count(rid))
                     continue;
                 auto &reg = regions.at(rid);
+                auto rows = p->spread_rows(reg.y0);
                 while (reg.overused(beta)) {
                     bool changed = false;
                     for (int j = 0; j < p->cfg.spread_scale_x; j++) {
@@ -1416,13 +1673,13 @@ class HeAPPlacer
                         }
                     }
                     for (int j = 0; j < p->cfg.spread_scale_y; j++) {
-                        if (reg.y0 > 0) {
+                        if (reg.y0 > rows.first) {
                             grow_region(reg, reg.x0, reg.y0 - 1, reg.x1, reg.y1);
                             changed = true;
                             if (!reg.overused(beta))
                                 break;
                         }
-                        if (reg.y1 < p->max_y) {
+                        if (reg.y1 < rows.second) {
                             grow_region(reg, reg.x0, reg.y0, reg.x1, reg.y1 + 1);
                             changed = true;
                             if (!reg.overused(beta))
@@ -1444,11 +1701,27 @@ class HeAPPlacer
         // Implementation of the recursive cut-based spreading as described in the HeAP paper
         // Note we use "left" to mean "-x/-y" depending on dir and "right" to mean "+x/+y" depending on dir
 
-        std::vector<CellInfo *> cut_cells;
+        // Cut a region, then queue tasks to cut the two halves in the other direction
+        void spread_region(TaskPool &pool, const SpreaderRegion &r, bool dir)
+        {
+            if (std::all_of(r.cells.begin(), r.cells.end(), [](int x) { return x == 0; }))
+                return;
+            SpreaderRegion rl, rr;
+            if (!cut_region(r, dir, rl, rr)) {
+                // Try the other dir, in case stuck in one direction only
+                if (!cut_region(r, !dir, rl, rr))
+                    return;
+                dir = !dir;
+            }
+            pool.add([this, &pool, rl, dir]() { spread_region(pool, rl, !dir); });
+            pool.add([this, &pool, rr, dir]() { spread_region(pool, rr, !dir); });
+        }
 
-        boost::optional<std::pair<int, int>> cut_region(SpreaderRegion &r, bool dir)
+        // Only reads and writes state for the cells and locations inside r, so may be run for disjoint regions in
+        // parallel. The two halves inherit the id of r.
+        bool cut_region(const SpreaderRegion &r, bool dir, SpreaderRegion &rl, SpreaderRegion &rr)
         {
-            cut_cells.clear();
+            std::vector<CellInfo *> cut_cells;
             auto &cal = cells_at_location;
             int total_cells = 0, total_bels = 0;
             for (int x = r.x0; x <= r.x1; x++) {
@@ -1467,7 +1740,7 @@ class HeAPPlacer
             });
 
             if (cut_cells.size() < 2)
-                return {};
+                return false;
             // Find the cells midpoint, counting chains in terms of their total size - making the initial source cut
             int pivot_cells = 0;
             int pivot = 0;
@@ -1530,7 +1803,7 @@ class HeAPPlacer
             }
             // log_info("tl %d tr %d cl %d cr %d\n", trimmed_l, trimmed_r, clearance_l, clearance_r);
             if ((trimmed_r - trimmed_l + 1) <= std::max(clearance_l, clearance_r))
-                return {};
+                return false;
             // Now find the initial target cut that minimises utilisation imbalance, whilst
             // meeting the clearance requirements for any large macros
             std::vector<int> left_cells_v(beltype.size(), 0), right_cells_v(beltype.size(), 0);
@@ -1572,7 +1845,7 @@ class HeAPPlacer
                 }
             }
             if (best_tgt_cut == -1)
-                return {};
+                return false;
             // left_bels = target_cut_bels.first;
             // right_bels = target_cut_bels.second;
             for (size_t t = 0; t < beltype.size(); t++) {
@@ -1593,7 +1866,7 @@ class HeAPPlacer
                 }
             if (std::accumulate(left_bels_v.begin(), left_bels_v.end(), 0) == 0 ||
                 std::accumulate(right_bels_v.begin(), right_bels_v.end(), 0) == 0)
-                return {};
+                return false;
             // log_info("pivot %d target cut %d lc %d lb %d rc %d rb %d\n", pivot, best_tgt_cut,
             // std::accumulate(left_cells_v.begin(), left_cells_v.end(), 0), std::accumulate(left_bels_v.begin(),
             // left_bels_v.end(), 0),
@@ -1686,31 +1959,429 @@ class HeAPPlacer
                 cells_at_location.at(cl.x).at(cl.y).push_back(cell);
                 // log_info("spread pos %d %d\n", cl.x, cl.y);
             }
-            SpreaderRegion rl, rr;
-            rl.id = int(regions.size());
+            rl.id = r.id;
             rl.x0 = r.x0;
             rl.y0 = r.y0;
             rl.x1 = dir ? r.x1 : best_tgt_cut;
             rl.y1 = dir ? best_tgt_cut : r.y1;
             rl.cells = left_cells_v;
             rl.bels = left_bels_v;
-            rr.id = int(regions.size()) + 1;
+            rr.id = r.id;
             rr.x0 = dir ? r.x0 : (best_tgt_cut + 1);
             rr.y0 = dir ? (best_tgt_cut + 1) : r.y0;
             rr.x1 = r.x1;
             rr.y1 = r.y1;
             rr.cells = right_cells_v;
             rr.bels = right_bels_v;
-            regions.push_back(rl);
-            regions.push_back(rr);
-            for (int x = rl.x0; x <= rl.x1; x++)
-                for (int y = rl.y0; y <= rl.y1; y++)
-                    groups.at(x).at(y) = rl.id;
-            for (int x = rr.x0; x <= rr.x1; x++)
-                for (int y = rr.y0; y <= rr.y1; y++)
-                    groups.at(x).at(y) = rr.id;
-            return std::make_pair(rl.id, rr.id);
+            return true;
+        };
+    };
+
+    // Min-cut partitioning of the cells being placed between the SLRs of a multi-die device, so that as few nets as
+    // possible cross between dies. Chains are kept whole, and cells with a region constraint stay in the SLR holding
+    // the middle of their region.
+    //
+    // The cost of a partition is the number of die boundaries crossed by each net, plus a penalty for each net
+    // crossing a boundary over its number of SLLs. An initial partition that splits the cells in order of connectivity
+    // is improved by passes of Fiduccia-Mattheyses refinement, moving each node at most once per pass and keeping the
+    // best partition seen.
+    class SlrPartitioner
+    {
+      public:
+        SlrPartitioner(HeAPPlacer *p) : p(p), ctx(p->ctx), num_slrs(int(p->slr_bounds.size())) {}
+
+        void run()
+        {
+            auto startt = std::chrono::high_resolution_clock::now();
+            init();
+            initial_partition();
+            int64_t initial_cost = total_cost();
+            int passes = 0;
+            while (passes < max_passes && fm_pass())
+                ++passes;
+
+            for (auto &n : nodes) {
+                if (n.fixed)
+                    continue;
+                p->cell_slr[n.root->name] = n.slr;
+                // Move the random initial location into the assigned SLR
+                auto &cl = p->cell_locs.at(n.root->name);
+                auto &bounds = p->slr_bounds.at(n.slr);
+                if (cl.y < bounds.y0 || cl.y > bounds.y1)
+                    cl.y = bounds.y0 + (cl.y * (bounds.y1 - bounds.y0 + 1)) / (p->max_y + 1);
+            }
+
+            auto endt = std::chrono::high_resolution_clock::now();
+            log_info("Partitioned %d cells between %d SLRs, cost %d -> %d after %d passes (%.02fs).\n",
+                     int(nodes.size()), num_slrs, int(initial_cost), int(total_cost()), passes,
+                     std::chrono::duration<double>(endt - startt).count());
+            for (int b = 0; b < num_slrs - 1; b++)
+                log_info("    %d nets crossing between SLR%d and SLR%d (%d SLLs)\n", crossings.at(b), b, b + 1,
+                         p->slr_sll_count.at(b));
+        }
+
+      private:
+        HeAPPlacer *p;
+        Context *ctx;
+        int num_slrs;
+
+        // A chain, or a single cell
+        struct Node
+        {
+            CellInfo *root;
+            int slr = 0;
+            bool fixed = false;
+            // Number of bels of each grid type used
+            std::vector<std::pair<int, int>> usage;
+            std::vector<int> nets;
         };
+        std::vector<Node> nodes;
+        std::unordered_map<IdString, int> node_of_cell;
+
+        // Nodes on each net, and the number of nodes or placed cells of each net in each SLR, at
+        // [net * num_slrs + slr]
+        std::vector<std::vector<int>> net_nodes;
+        std::vector<int> net_pins;
+        // Number of nets crossing the boundary between SLR b and SLR b + 1
+        std::vector<int> crossings;
+        std::vector<int> crossings_delta;
+        // Bels of each grid type used in each SLR, and the most that may be used
+        std::vector<std::vector<int>> load, limit;
+
+        // Each SLR may be filled with each type of bel to this, or to the device-wide utilisation of the type plus
+        // util_slack, if that is higher
+        const double max_slr_util = 0.7, util_slack = 0.1;
+        // Cost of each net crossing a boundary over the number of SLLs across it
+        const int sll_overflow_cost = 4;
+        // Moving a node doesn't update the gains of other nodes on nets larger than this, for speed; they are only
+        // recomputed before they are moved
+        const int max_update_net_size = 64;
+        const int max_passes = 10;
+
+        void add_to_node(int idx, CellInfo *cell)
+        {
+            node_of_cell[cell->name] = idx;
+            int type = p->grid->type_index(cell->type);
+            if (type != -1) {
+                auto &usage = nodes.at(idx).usage;
+                auto fnd = std::find_if(usage.begin(), usage.end(),
+                                        [type](const std::pair<int, int> &u) { return u.first == type; });
+                if (fnd == usage.end())
+                    usage.emplace_back(type, 1);
+                else
+                    ++fnd->second;
+            }
+            for (auto child : cell->constr_children)
+                add_to_node(idx, child);
+        }
+
+        void init()
+        {
+            for (auto cell : p->place_cells) {
+                int idx = int(nodes.size());
+                nodes.emplace_back();
+                nodes.back().root = cell;
+                add_to_node(idx, cell);
+                if (cell->region != nullptr && cell->region->constr_bels) {
+                    auto &bounds = p->constraint_region_bounds.at(cell->region->name);
+                    nodes.back().slr = p->slr_of_row.at(std::min(p->max_y, (bounds.y0 + bounds.y1) / 2));
+                    nodes.back().fixed = true;
+                }
+            }
+
+            for (auto net : sorted(ctx->nets)) {
+                NetInfo *ni = net.second;
+                if (ni->driver.cell == nullptr || ni->users.empty())
+                    continue;
+                if (p->cell_locs.at(ni->driver.cell->name).global)
+                    continue;
+                std::vector<int> on_net;
+                std::vector<int> placed(num_slrs, 0);
+                p->foreach_port(ni, [&](PortRef &port, int user_idx) {
+                    auto fnd = node_of_cell.find(port.cell->name);
+                    if (fnd != node_of_cell.end())
+                        on_net.push_back(fnd->second);
+                    else
+                        ++placed.at(p->slr_of_row.at(std::min(p->max_y, p->cell_locs.at(port.cell->name).y)));
+                });
+                std::sort(on_net.begin(), on_net.end());
+                on_net.erase(std::unique(on_net.begin(), on_net.end()), on_net.end());
+                if (on_net.empty() || (on_net.size() == 1 && std::all_of(placed.begin(), placed.end(),
+                                                                         [](int n) { return n == 0; })))
+                    continue;
+                int idx = int(net_nodes.size());
+                for (int v : on_net)
+                    nodes.at(v).nets.push_back(idx);
+                net_nodes.push_back(std::move(on_net));
+                net_pins.insert(net_pins.end(), placed.begin(), placed.end());
+            }
+
+            int num_types = p->grid->num_types();
+            std::vector<std::vector<int>> capacity(num_slrs, std::vector<int>(num_types, 0));
+            for (int t = 0; t < num_types; t++)
+                for (int x = 0; x <= p->max_x; x++)
+                    for (int y = 0; y <= p->max_y; y++)
+                        capacity.at(p->slr_of_row.at(y)).at(t) += p->usable_bels_at(t, x, y);
+            std::vector<int> used(num_types, 0), total(num_types, 0);
+            for (auto &n : nodes)
+                for (auto &u : n.usage)
+                    used.at(u.first) += u.second;
+            for (int s = 0; s < num_slrs; s++)
+                for (int t = 0; t < num_types; t++)
+                    total.at(t) += capacity.at(s).at(t);
+            load.assign(num_slrs, std::vector<int>(num_types, 0));
+            limit.assign(num_slrs, std::vector<int>(num_types, 0));
+            for (int t = 0; t < num_types; t++) {
+                double util = (total.at(t) == 0) ? 1.0 : (double(used.at(t)) / total.at(t) + util_slack);
+                util = std::min(1.0, std::max(max_slr_util, util));
+                for (int s = 0; s < num_slrs; s++)
+                    limit.at(s).at(t) = int(capacity.at(s).at(t) * util);
+            }
+            crossings.assign(num_slrs - 1, 0);
+            crossings_delta.assign(num_slrs - 1, 0);
+        }
+
+        bool fits(int v, int slr) const
+        {
+            for (auto &u : nodes.at(v).usage)
+                if (load.at(slr).at(u.first) + u.second > limit.at(slr).at(u.first))
+                    return false;
+            return true;
+        }
+
+        // Assign nodes to SLRs before any refinement
+        void initial_partition()
+        {
+            // Order the nodes by a breadth-first search of the connectivity, so that connected nodes are close
+            std::vector<int> order;
+            std::vector<bool> visited(nodes.size(), false);
+            for (int start = 0; start < int(nodes.size()); start++) {
+                if (visited.at(start))
+                    continue;
+                std::queue<int> visit;
+                visit.push(start);
+                visited.at(start) = true;
+                while (!visit.empty()) {
+                    int v = visit.front();
+                    visit.pop();
+                    order.push_back(v);
+                    for (int net : nodes.at(v).nets) {
+                        if (int(net_nodes.at(net).size()) > max_update_net_size)
+                            continue;
+                        for (int u : net_nodes.at(net))
+                            if (!visited.at(u)) {
+                                visited.at(u) = true;
+                                visit.push(u);
+                            }
+                    }
+                }
+            }
+
+            int num_types = p->grid->num_types();
+            for (auto &n : nodes)
+                if (n.fixed)
+                    for (auto &u : n.usage)
+                        load.at(n.slr).at(u.first) += u.second;
+            // Then split the nodes between the SLRs in that order, in proportion to the limit of each SLR for the
+            // type of bel that each node uses most
+            std::vector<int> to_place(num_types, 0), placed(num_types, 0);
+            for (auto &n : nodes)
+                if (!n.fixed)
+                    for (auto &u : n.usage)
+                        to_place.at(u.first) += u.second;
+            for (int v : order) {
+                Node &n = nodes.at(v);
+                if (n.fixed)
+                    continue;
+                if (n.usage.empty()) {
+                    n.slr = p->slr_of_row.at(p->cell_locs.at(n.root->name).y);
+                    continue;
+                }
+                auto main = *std::max_element(
+                        n.usage.begin(), n.usage.end(),
+                        [](const std::pair<int, int> &a, const std::pair<int, int> &b) { return a.second < b.second; });
+                int t = main.first;
+                int total_limit = 0;
+                for (int s = 0; s < num_slrs; s++)
+                    total_limit += limit.at(s).at(t);
+                double target = (placed.at(t) + 0.5 * main.second) / to_place.at(t) * total_limit;
+                placed.at(t) += main.second;
+                int slr = 0, slr_limit = limit.at(0).at(t);
+                while (slr < num_slrs - 1 && slr_limit < target)
+                    slr_limit += limit.at(++slr).at(t);
+                // If that SLR is full, use the nearest one with room
+                for (int d = 1; d < num_slrs && !fits(v, slr); d++) {
+                    if (slr - d >= 0 && fits(v, slr - d)) {
+                        slr -= d;
+                        break;
+                    }
+                    if (slr + d < num_slrs && fits(v, slr + d)) {
+                        slr += d;
+                        break;
+                    }
+                }
+                n.slr = slr;
+                for (auto &u : n.usage)
+                    load.at(slr).at(u.first) += u.second;
+            }
+
+            for (int v = 0; v < int(nodes.size()); v++)
+                for (int net : nodes.at(v).nets)
+                    ++net_pins.at(net * num_slrs + nodes.at(v).slr);
+            for (int net = 0; net < int(net_nodes.size()); net++) {
+                auto range = net_range(net);
+                for (int b = range.first; b < range.second; b++)
+                    ++crossings.at(b);
+            }
+        }
+
+        // Lowest and highest SLR containing part of a net
+        std::pair<int, int> net_range(int net) const
+        {
+            const int *pins = &net_pins.at(net * num_slrs);
+            int lo = 0, hi = num_slrs - 1;
+            while (lo < hi && pins[lo] == 0)
+                ++lo;
+            while (hi > lo && pins[hi] == 0)
+                --hi;
+            return std::make_pair(lo, hi);
+        }
+
+        int overflow(int b, int nets) const
+        {
+            // Devices where the number of SLLs isn't known have no limit
+            int slls = p->slr_sll_count.at(b);
+            return slls > 0 ? std::max(0, nets - slls) : 0;
+        }
+
+        int64_t total_cost() const
+        {
+            int64_t cost = 0;
+            for (int net = 0; net < int(net_nodes.size()); net++) {
+                auto range = net_range(net);
+                cost += range.second - range.first;
+            }
+            for (int b = 0; b < num_slrs - 1; b++)
+                cost += sll_overflow_cost * overflow(b, crossings.at(b));
+            return cost;
+        }
+
+        // Reduction in cost from moving a node to another SLR
+        int move_gain(int v, int slr)
+        {
+            Node &n = nodes.at(v);
+            std::fill(crossings_delta.begin(), crossings_delta.end(), 0);
+            int gain = 0;
+            for (int net : n.nets) {
+                auto before = net_range(net);
+                --net_pins.at(net * num_slrs + n.slr);
+                ++net_pins.at(net * num_slrs + slr);
+                auto after = net_range(net);
+                ++net_pins.at(net * num_slrs + n.slr);
+                --net_pins.at(net * num_slrs + slr);
+                gain += (before.second - before.first) - (after.second - after.first);
+                for (int b = before.first; b < before.second; b++)
+                    --crossings_delta.at(b);
+                for (int b = after.first; b < after.second; b++)
+                    ++crossings_delta.at(b);
+            }
+            for (int b = 0; b < num_slrs - 1; b++)
+                gain -= sll_overflow_cost *
+                        (overflow(b, crossings.at(b) + crossings_delta.at(b)) - overflow(b, crossings.at(b)));
+            return gain;
+        }
+
+        void move_node(int v, int slr)
+        {
+            Node &n = nodes.at(v);
+            for (int net : n.nets) {
+                auto before = net_range(net);
+                --net_pins.at(net * num_slrs + n.slr);
+                ++net_pins.at(net * num_slrs + slr);
+                auto after = net_range(net);
+                for (int b = before.first; b < before.second; b++)
+                    --crossings.at(b);
+                for (int b = after.first; b < after.second; b++)
+                    ++crossings.at(b);
+            }
+            for (auto &u : n.usage) {
+                load.at(n.slr).at(u.first) -= u.second;
+                load.at(slr).at(u.first) += u.second;
+            }
+            n.slr = slr;
+        }
+
+        // Run one pass of refinement, returning true if it reduced the cost
+        bool fm_pass()
+        {
+            // Gain, negated node index so that ties are broken towards lower indices, target SLR and version
+            typedef std::tuple<int, int, int, int> Move;
+            std::priority_queue<Move> queue;
+            std::vector<int> version(nodes.size(), 0);
+            std::vector<bool> locked(nodes.size(), false);
+
+            auto queue_best_move = [&](int v) {
+                ++version.at(v);
+                int best_slr = -1, best_gain = 0;
+                for (int slr = 0; slr < num_slrs; slr++) {
+                    if (slr == nodes.at(v).slr || !fits(v, slr))
+                        continue;
+                    int gain = move_gain(v, slr);
+                    if (best_slr == -1 || gain > best_gain) {
+                        best_slr = slr;
+                        best_gain = gain;
+                    }
+                }
+                if (best_slr != -1)
+                    queue.emplace(best_gain, -v, best_slr, version.at(v));
+            };
+
+            for (int v = 0; v < int(nodes.size()); v++) {
+                locked.at(v) = nodes.at(v).fixed;
+                if (!locked.at(v))
+                    queue_best_move(v);
+            }
+
+            std::vector<std::pair<int, int>> moves;
+            int total_gain = 0, best_gain = 0;
+            size_t best_moves = 0;
+            size_t max_stall = std::max<size_t>(100, nodes.size() / 20);
+            while (!queue.empty()) {
+                Move m = queue.top();
+                queue.pop();
+                int gain = std::get<0>(m), v = -std::get<1>(m), slr = std::get<2>(m);
+                if (locked.at(v) || std::get<3>(m) != version.at(v))
+                    continue;
+                // The queued move may be out of date, if it no longer fits or the gain changed without an update
+                if (!fits(v, slr) || move_gain(v, slr) != gain) {
+                    queue_best_move(v);
+                    continue;
+                }
+                moves.emplace_back(v, nodes.at(v).slr);
+                move_node(v, slr);
+                locked.at(v) = true;
+                total_gain += gain;
+                if (total_gain > best_gain) {
+                    best_gain = total_gain;
+                    best_moves = moves.size();
+                } else if (moves.size() - best_moves > max_stall) {
+                    break;
+                }
+                for (int net : nodes.at(v).nets) {
+                    if (int(net_nodes.at(net).size()) > max_update_net_size)
+                        continue;
+                    for (int u : net_nodes.at(net))
+                        if (!locked.at(u))
+                            queue_best_move(u);
+                }
+            }
+            // Undo the moves made after the best partition of the pass
+            while (moves.size() > best_moves) {
+                move_node(moves.back().first, moves.back().second);
+                moves.pop_back();
+            }
+            return best_gain > 0;
+        }
     };
     typedef decltype(CellInfo::udata) cell_udata_t;
     cell_udata_t dont_solve = std::numeric_limits<cell_udata_t>::max();
@@ -1729,10 +2400,36 @@ PlacerHeapCfg::PlacerHeapCfg(Context *ctx)
     solverTolerance = 1e-5;
     placeAllAtOnce = false;
 
+    std::string model_name = str_or_default(ctx->settings, ctx->id("placerHeap/netModel"), "b2b");
+    if (model_name == "b2b")
+        netModel = NET_MODEL_B2B;
+    else if (model_name == "star")
+        netModel = NET_MODEL_STAR;
+    else if (model_name == "hybrid")
+        netModel = NET_MODEL_HYBRID;
+    else
+        log_error("unknown HeAP net model '%s' (expected 'b2b', 'star' or 'hybrid')\n", model_name.c_str());
+    starNetThreshold = ctx->setting<int>("placerHeap/starNetThreshold", 32);
+    slrPartition = ctx->setting<bool>("placerHeap/slrPartition", false);
+    parallelLegalise = ctx->setting<bool>("placerHeap/parallelLegalise", false);
+    perfReport = str_or_default(ctx->settings, ctx->id("placer/perfReport"), "");
+
+    std::string solver_name = str_or_default(ctx->settings, ctx->id("placerHeap/solver"), "cg");
+    if (solver_name == "cg")
+        solver = SOLVER_CG;
+    else if (solver_name == "iccg")
+        solver = SOLVER_ICCG;
+    else
+        log_error("unknown HeAP equation solver '%s' (expected 'cg' or 'iccg')\n", solver_name.c_str());
+
     hpwl_scale_x = 1;
     hpwl_scale_y = 1;
     spread_scale_x = 1;
     spread_scale_y = 1;
+
+    threads = get_thread_count(ctx);
+    // Only has an effect when built with USE_OPENMP
+    solverThreads = std::max(1, ctx->setting<int>("placerHeap/solverThreads", threads));
 }
 
 NEXTPNR_NAMESPACE_END
@@ -40,12 +40,41 @@ struct PlacerHeapCfg
     float timingWeight;
     bool timing_driven;
     float solverTolerance;
+    // Conjugate gradient with the default diagonal preconditioner, or with incomplete Cholesky
+    enum SolverType
+    {
+        SOLVER_CG,
+        SOLVER_ICCG
+    } solver;
+    // Bound-to-bound connects every pin to the two extreme pins of its net. Star adds a variable per net that every
+    // pin connects to, which needs fewer connections for large nets. Hybrid uses star only for nets with more than
+    // starNetThreshold pins.
+    enum NetModel
+    {
+        NET_MODEL_B2B,
+        NET_MODEL_STAR,
+        NET_MODEL_HYBRID
+    } netModel;
+    int starNetThreshold;
+    // Number of OpenMP threads shared by the x and y equation solvers
+    int solverThreads;
+    // On multi-die devices, partition the cells between the dies to minimise the nets crossing between them, and
+    // keep each cell within the rows of its die throughout placement
+    bool slrPartition;
+    // Legalise cells in a grid of regions of the device on several threads before the serial pass, which changes the
+    // placement found. Off by default, so that the number of threads doesn't change results.
+    bool parallelLegalise;
+    // File to write a placement performance report to, if not empty
+    std::string perfReport;
     bool placeAllAtOnce;
     float netShareWeight;
 
     int hpwl_scale_x, hpwl_scale_y;
     int spread_scale_x, spread_scale_y;
 
+    // Number of threads to use for parallel legalisation and spreading
+    int threads;
+
     // These cell types will be randomly locked to prevent singular matrices
     std::unordered_set<IdString> ioBufTypes;
     // These cell types are part of the same unit (e.g. slices split into
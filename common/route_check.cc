@@ -0,0 +1,121 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "route_check.h"
+#include <unordered_set>
+#include "log.h"
+#include "task_pool.h"
+#include "util.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+// Only reads the Arch and netlist, so may be run for many nets in parallel
+bool check_net(const Context *ctx, const NetInfo *net)
+{
+#ifdef ARCH_ECP5
+    // ECP5 global nets appear part-unrouted due to arch database limitations, and are left alone by the routers
+    if (net->is_global)
+        return true;
+#endif
+    if (net->driver.cell == nullptr)
+        return true;
+    WireId src_wire = ctx->getNetinfoSourceWire(net);
+    if (src_wire == WireId())
+        return false;
+
+    for (auto &w : net->wires) {
+        if (ctx->getBoundWireNet(w.first) != net)
+            return false;
+        PipId pip = w.second.pip;
+        if (pip == PipId()) {
+            // Only the source, or locked pre-routing, may be bound without a driving pip
+            if (w.first != src_wire && w.second.strength < STRENGTH_LOCKED)
+                return false;
+            continue;
+        }
+        if (ctx->getBoundPipNet(pip) != net || ctx->getPipDstWire(pip) != w.first ||
+            !net->wires.count(ctx->getPipSrcWire(pip)))
+            return false;
+#ifdef ARCH_XILINX
+        // Pips made unusable by the placement, including LUT permutation pips into LUTRAMs and SRLs
+        if (ctx->usp_pip_hard_unavail(pip))
+            return false;
+#endif
+    }
+
+    // Walk back from each sink until reaching the source or a wire already known to lead to it
+    std::unordered_set<WireId> reached;
+    std::vector<WireId> path;
+    reached.insert(src_wire);
+    for (auto &usr : net->users) {
+        WireId cursor = ctx->getNetinfoSinkWire(net, usr);
+        if (cursor == WireId())
+            return false;
+        path.clear();
+        while (!reached.count(cursor)) {
+            auto fnd = net->wires.find(cursor);
+            // The length limit catches loops
+            if (fnd == net->wires.end() || fnd->second.pip == PipId() || path.size() > net->wires.size())
+                return false;
+            path.push_back(cursor);
+            cursor = ctx->getPipSrcWire(fnd->second.pip);
+        }
+        reached.insert(path.begin(), path.end());
+    }
+
+    // Wires leading to no sink would be left behind by router1
+    for (auto &w : net->wires)
+        if (w.second.strength < STRENGTH_LOCKED && !reached.count(w.first))
+            return false;
+    return true;
+}
+} // namespace
+
+bool check_routing(Context *ctx, std::vector<NetInfo *> &failed, int threads)
+{
+    std::vector<NetInfo *> nets;
+    for (auto net : sorted(ctx->nets))
+        nets.push_back(net.second);
+    std::vector<uint8_t> ok(nets.size(), 1);
+
+    TaskPool pool(threads);
+    const size_t chunk_size = 256;
+    for (size_t start = 0; start < nets.size(); start += chunk_size) {
+        size_t end = std::min(nets.size(), start + chunk_size);
+        pool.add([ctx, &nets, &ok, start, end]() {
+            for (size_t i = start; i < end; i++)
+                ok.at(i) = check_net(ctx, nets.at(i));
+        });
+    }
+    pool.run();
+
+    bool success = true;
+    for (size_t i = 0; i < nets.size(); i++) {
+        if (ok.at(i))
+            continue;
+        if (ctx->debug)
+            log_info("    net '%s' failed route check\n", ctx->nameOf(nets.at(i)));
+        failed.push_back(nets.at(i));
+        success = false;
+    }
+    return success;
+}
+
+NEXTPNR_NAMESPACE_END
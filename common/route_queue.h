@@ -0,0 +1,121 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef ROUTE_QUEUE_H
+#define ROUTE_QUEUE_H
+
+#include <algorithm>
+#include <vector>
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Priority queue for router searches, popping the entry with the lowest key first. By default this is a binary
+// heap ordered by Greater, exactly as std::priority_queue. In bucketed mode, keys are instead rounded down to a
+// multiple of bucket_width and entries are kept in one bucket per multiple, making push and pop constant time at
+// the cost of popping entries within a bucket in LIFO rather than exact order. Keys need not be monotone; keys
+// beyond the last bucket fall back to a heap. clear() keeps all allocations, so that one queue can be reused for
+// every search.
+template <typename T, typename Greater> struct RouteQueue
+{
+    RouteQueue() {}
+    RouteQueue(bool bucketed, float bucket_width) { set_bucketed(bucketed, bucket_width); }
+
+    void set_bucketed(bool bucketed, float bucket_width)
+    {
+        NPNR_ASSERT(empty());
+        this->bucketed = bucketed;
+        inv_width = 1.0f / bucket_width;
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    void push(const T &item, float key)
+    {
+        ++count;
+        if (!bucketed) {
+            heap.push_back(item);
+            std::push_heap(heap.begin(), heap.end(), Greater());
+            return;
+        }
+        float b = std::max(0.0f, key * inv_width);
+        if (b >= float(max_buckets)) {
+            heap.push_back(item);
+            std::push_heap(heap.begin(), heap.end(), Greater());
+            return;
+        }
+        int idx = int(b);
+        if (idx >= int(buckets.size()))
+            buckets.resize(idx + 1);
+        buckets[idx].push_back(item);
+        cursor = std::min(cursor, idx);
+        used_end = std::max(used_end, idx + 1);
+    }
+
+    const T &top()
+    {
+        NPNR_ASSERT(!empty());
+        if (bucketed) {
+            while (cursor < used_end && buckets[cursor].empty())
+                ++cursor;
+            if (cursor < used_end)
+                return buckets[cursor].back();
+        }
+        return heap.front();
+    }
+
+    void pop()
+    {
+        top();
+        --count;
+        if (bucketed && cursor < used_end) {
+            buckets[cursor].pop_back();
+            return;
+        }
+        std::pop_heap(heap.begin(), heap.end(), Greater());
+        heap.pop_back();
+    }
+
+    void clear()
+    {
+        for (int i = cursor; i < used_end; i++)
+            buckets[i].clear();
+        heap.clear();
+        count = 0;
+        cursor = max_buckets;
+        used_end = 0;
+    }
+
+  private:
+    // Memory use is bounded by limiting the number of buckets
+    static const int max_buckets = 1 << 16;
+
+    bool bucketed = false;
+    float inv_width = 1.0f;
+    size_t count = 0;
+    std::vector<T> heap;
+    std::vector<std::vector<T>> buckets;
+    // All buckets below cursor, and from used_end on, are empty
+    int cursor = max_buckets, used_end = 0;
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
@@ -22,6 +22,7 @@
 #include <queue>
 
 #include "log.h"
+#include "route_queue.h"
 #include "router1.h"
 #include "timing.h"
 
@@ -89,6 +90,79 @@ struct QueuedWire
             return l == r ? lhs.randtag > rhs.randtag : l > r;
         }
     };
+
+    float key() const { return float(delay + penalty + togo - bonus); }
+};
+
+// Per-wire router state. Entries are kept in a hash map while there are few of them, so that rerouting a handful
+// of nets doesn't pay for device-sized arrays. Once a map has grown large, and where the Arch provides a flat wire
+// index, it switches to a slot array indexed by wire pointing into a compact entry list, so that lookups need no
+// hashing; clear() then only resets the slots that were used.
+template <typename T> struct WireMap
+{
+    explicit WireMap(const Context *ctx) : ctx(ctx) {}
+
+    bool count(WireId wire) { return find(wire) != nullptr; }
+
+    T *find(WireId wire)
+    {
+#ifdef ARCH_XILINX
+        if (!slot.empty()) {
+            int s = slot[ctx->getWireIndex(wire)];
+            return (s == -1) ? nullptr : &entries[s].second;
+        }
+#endif
+        auto fnd = data.find(wire);
+        return (fnd == data.end()) ? nullptr : &fnd->second;
+    }
+
+    T &operator[](WireId wire)
+    {
+#ifdef ARCH_XILINX
+        if (slot.empty() && data.size() >= flat_threshold)
+            make_flat();
+        if (!slot.empty()) {
+            int idx = ctx->getWireIndex(wire);
+            if (slot[idx] == -1) {
+                slot[idx] = int(entries.size());
+                entries.emplace_back(idx, T());
+            }
+            return entries[slot[idx]].second;
+        }
+#endif
+        return data[wire];
+    }
+
+    void clear()
+    {
+#ifdef ARCH_XILINX
+        for (auto &e : entries)
+            slot[e.first] = -1;
+        entries.clear();
+#endif
+        data.clear();
+    }
+
+  private:
+    const Context *ctx;
+    std::unordered_map<WireId, T> data;
+#ifdef ARCH_XILINX
+    // Number of entries at which the map switches to the slot array, which then stays allocated
+    static const size_t flat_threshold = 1 << 16;
+    std::vector<int> slot;
+    std::vector<std::pair<int, T>> entries;
+
+    void make_flat()
+    {
+        slot.assign(ctx->getNumWires(), -1);
+        for (auto &d : data) {
+            int idx = ctx->getWireIndex(d.first);
+            slot[idx] = int(entries.size());
+            entries.emplace_back(idx, std::move(d.second));
+        }
+        data.clear();
+    }
+#endif
 };
 
 struct Router1
@@ -101,17 +175,20 @@ struct Router1
     std::unordered_map<arc_key, std::unordered_set<WireId>, arc_key::Hash> arc_to_wires;
     std::unordered_set<arc_key, arc_key::Hash> queued_arcs;
 
-    std::unordered_map<WireId, QueuedWire> visited;
-    std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> queue;
+    WireMap<QueuedWire> visited;
+    RouteQueue<QueuedWire, QueuedWire::Greater> queue;
 
-    std::unordered_map<WireId, int> wireScores;
+    WireMap<int> wireScores;
     std::unordered_map<NetInfo *, int> netScores;
 
     int arcs_with_ripup = 0;
     int arcs_without_ripup = 0;
     bool ripup_flag;
 
-    Router1(Context *ctx, const Router1Cfg &cfg) : ctx(ctx), cfg(cfg) {}
+    Router1(Context *ctx, const Router1Cfg &cfg)
+            : ctx(ctx), cfg(cfg), visited(ctx), queue(cfg.bucketQueue, cfg.bucketWidth), wireScores(ctx)
+    {
+    }
 
     void arc_queue_insert(const arc_key &arc, WireId src_wire, WireId dst_wire)
     {
@@ -476,10 +553,7 @@ struct Router1
 
         // reset wire queue
 
-        if (!queue.empty()) {
-            std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> new_queue;
-            queue.swap(new_queue);
-        }
+        queue.clear();
         visited.clear();
 
         // A* main loop
@@ -502,7 +576,7 @@ struct Router1
             }
             qw.randtag = ctx->rng();
 
-            queue.push(qw);
+            queue.push(qw, qw.key());
             visited[qw.wire] = qw;
         }
 
@@ -589,10 +663,10 @@ struct Router1
                         conflictWireNet = nullptr;
 
                     if (conflictWireWire != WireId()) {
-                        auto scores_it = wireScores.find(conflictWireWire);
+                        int *wire_score = wireScores.find(conflictWireWire);
                         delay_t wire_penalty = ctx->getWireRipupDelayPenalty(conflictWireWire);
-                        if (scores_it != wireScores.end())
-                            next_penalty += scores_it->second * wire_penalty;
+                        if (wire_score != nullptr)
+                            next_penalty += *wire_score * wire_penalty;
                         next_penalty += wire_penalty;
 
                         NetInfo *bound = ctx->getBoundWireNet(conflictWireWire);
@@ -604,10 +678,10 @@ struct Router1
                     }
 
                     if (conflictPipWire != WireId()) {
-                        auto scores_it = wireScores.find(conflictPipWire);
+                        int *wire_score = wireScores.find(conflictPipWire);
                         delay_t wire_penalty = ctx->getWireRipupDelayPenalty(conflictPipWire);
-                        if (scores_it != wireScores.end())
-                            next_penalty += scores_it->second * wire_penalty;
+                        if (wire_score != nullptr)
+                            next_penalty += *wire_score * wire_penalty;
                         next_penalty += wire_penalty;
 
                         NetInfo *bound = ctx->getBoundWireNet(conflictPipWire);
@@ -638,10 +712,10 @@ struct Router1
                     int bb_dist = bounds.distance(piploc);
                     next_penalty += ctx->getBoundingBoxCost(src_wire, dst_wire, bb_dist);
 
-                    auto scores_it = wireScores.find(next_wire);
+                    int *wire_score = wireScores.find(next_wire);
                     delay_t wire_penalty = ctx->getWireRipupDelayPenalty(next_wire);
-                    if (scores_it != wireScores.end())
-                        next_penalty += (scores_it->second * wire_penalty) / 5;
+                    if (wire_score != nullptr)
+                        next_penalty += (*wire_score * wire_penalty) / 5;
                 }
 
                 delay_t next_score = next_delay + next_penalty;
@@ -650,10 +724,10 @@ struct Router1
                 if ((best_score >= 0) && (next_score - next_bonus - cfg.estimatePrecision > best_score))
                     continue;
 
-                auto old_visited_it = visited.find(next_wire);
-                if (old_visited_it != visited.end()) {
-                    delay_t old_delay = old_visited_it->second.delay;
-                    delay_t old_score = old_delay + old_visited_it->second.penalty;
+                QueuedWire *old_visited = visited.find(next_wire);
+                if (old_visited != nullptr) {
+                    delay_t old_delay = old_visited->delay;
+                    delay_t old_score = old_delay + old_visited->penalty;
                     NPNR_ASSERT(old_score >= 0);
 
                     if (next_score + ctx->getDelayEpsilon() >= old_score)
@@ -664,7 +738,7 @@ struct Router1
                         log("Found better route to %s. Old vs new delay estimate: %.3f (%.3f) %.3f (%.3f)\n",
                             ctx->nameOfWire(next_wire),
                             ctx->getDelayNS(old_score),
-                            ctx->getDelayNS(old_visited_it->second.delay),
+                            ctx->getDelayNS(old_visited->delay),
                             ctx->getDelayNS(next_score),
                             ctx->getDelayNS(next_delay));
 #endif
@@ -696,7 +770,7 @@ struct Router1
 #endif
 
                 visited[next_qw.wire] = next_qw;
-                queue.push(next_qw);
+                queue.push(next_qw, next_qw.key());
 
                 if (next_wire == dst_wire) {
                     maxVisitCnt = std::min(maxVisitCnt, visitCnt + 5);
@@ -741,7 +815,7 @@ struct Router1
 
                 last_path_delay_delta = path_delay_delta;
                 if (wireScores.count(cursor))
-                    log("         wire score %d\n", wireScores.at(cursor));
+                    log("         wire score %d\n", wireScores[cursor]);
                 if (pip != PipId())
                     accumulated_path_delay += ctx->getPipDelay(pip).maxDelay();
                 accumulated_path_delay += ctx->getWireDelay(cursor).maxDelay();
@@ -808,6 +882,9 @@ Router1Cfg::Router1Cfg(Context *ctx)
     reuseBonus = wireRipupPenalty / 2;
 
     estimatePrecision = 100 * ctx->getRipupDelayPenalty();
+
+    bucketQueue = ctx->setting<bool>("router1/bucketQueue", false);
+    bucketWidth = ctx->setting<float>("router1/bucketWidth", float(ctx->getDelayEpsilon()));
 }
 
 bool router1(Context *ctx, const Router1Cfg &cfg)
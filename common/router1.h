@@ -36,6 +36,8 @@ struct Router1Cfg
     delay_t netRipupPenalty;
     delay_t reuseBonus;
     delay_t estimatePrecision;
+    bool bucketQueue;
+    float bucketWidth;
 };
 
 extern bool router1(Context *ctx, const Router1Cfg &cfg);
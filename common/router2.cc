@@ -28,16 +28,24 @@
 
 #include "router2.h"
 #include <algorithm>
-#include <boost/container/flat_map.hpp>
+#include <atomic>
 #include <chrono>
 #include <deque>
 #include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <queue>
 #include <thread>
+#include <unordered_set>
 #include "log.h"
 #include "nextpnr.h"
+#include "route_check.h"
+#include "route_queue.h"
 #include "router1.h"
+#include "task_pool.h"
 #include "timing.h"
+#include "timing_graph.h"
 #include "util.h"
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -76,33 +84,122 @@ struct Router2
         float total() const { return cost + togo_cost; }
     };
 
-    struct PerWireData
+    // Binding of one net to a wire
+    struct WireBinding
     {
-        // nextpnr
-        WireId w;
-        // net --> number of arcs; driving pip
-        boost::container::flat_map<int, std::pair<int, PipId>> bound_nets;
-        // Historical congestion cost
-        float hist_cong_cost = 1.0;
+        // Net udata, or -1 if unused
+        int net = -1;
+        // Number of arcs of the net using the wire
+        int uses = 0;
+        // Pip driving the wire for this net
+        PipId pip;
+    };
+
+    enum WireFlags : uint8_t
+    {
+        WIRE_VISITED = 0x01,
+        WIRE_DIRTY = 0x02,
         // Wire is unavailable as locked to another arc
-        bool unavailable = false;
-        // This wire has to be used for this net
-        int reserved_net = -1;
-        // The notional location of the wire, to guarantee thread safety
-        int16_t x = 0, y = 0;
-        // Visit data
-        struct
-        {
-            bool dirty = false, visited = false;
-            PipId pip;
-            WireScore score;
-        } visit;
+        WIRE_UNAVAILABLE = 0x04,
+        // More than one net is bound, with the extra bindings in bound_extra
+        WIRE_MULTI_BOUND = 0x08,
     };
 
-    float present_wire_cost(const PerWireData &w, int net_uid)
+    // Per-wire data is stored as a structure of arrays indexed by flat wire index, so that the A* inner
+    // loop only pulls the hot search state (flags, visit cost and back-pointer) through the cache
+
+    // Search state
+    std::vector<uint8_t> wire_flags;
+    std::vector<float> visit_cost;
+    std::vector<PipId> visit_pip;
+    // Historical congestion cost
+    std::vector<float> hist_cong_cost;
+    // The net a wire has to be used for, or -1
+    std::vector<int> reserved_net;
+    // First net bound to each wire; in the rare case of more than one net, the others are in a side table
+    std::vector<WireBinding> wire_bound;
+    std::vector<std::unique_ptr<std::vector<WireBinding>>> bound_extra;
+    // nextpnr wire
+    std::vector<WireId> wire_ids;
+    // The notional location of the wire, to guarantee thread safety
+    std::vector<std::pair<int16_t, int16_t>> wire_loc;
+
+    int bound_count(int wire) const
+    {
+        if (wire_bound[wire].net == -1)
+            return 0;
+        if (!(wire_flags[wire] & WIRE_MULTI_BOUND))
+            return 1;
+        return 1 + int(bound_extra[wire]->size());
+    }
+
+    // Get the binding of a net to a wire, or nullptr if the net doesn't use the wire
+    WireBinding *find_binding(int wire, int net)
+    {
+        auto &b = wire_bound[wire];
+        if (b.net == net)
+            return &b;
+        if (wire_flags[wire] & WIRE_MULTI_BOUND)
+            for (auto &eb : *bound_extra[wire])
+                if (eb.net == net)
+                    return &eb;
+        return nullptr;
+    }
+
+    bool is_bound(int wire, int net) { return find_binding(wire, net) != nullptr; }
+
+    template <typename Tf> void for_each_binding(int wire, Tf func) const
+    {
+        if (wire_bound[wire].net == -1)
+            return;
+        func(wire_bound[wire]);
+        if (wire_flags[wire] & WIRE_MULTI_BOUND)
+            for (auto &eb : *bound_extra[wire])
+                func(eb);
+    }
+
+    WireBinding &add_binding(int wire, int net)
+    {
+        auto &b = wire_bound[wire];
+        if (b.net == -1) {
+            b.net = net;
+            return b;
+        }
+        if (!bound_extra[wire])
+            bound_extra[wire].reset(new std::vector<WireBinding>());
+        wire_flags[wire] |= WIRE_MULTI_BOUND;
+        bound_extra[wire]->emplace_back();
+        bound_extra[wire]->back().net = net;
+        return bound_extra[wire]->back();
+    }
+
+    void remove_binding(int wire, int net)
     {
-        int other_sources = int(w.bound_nets.size());
-        if (w.bound_nets.count(net_uid))
+        auto &b = wire_bound[wire];
+        bool multi = (wire_flags[wire] & WIRE_MULTI_BOUND);
+        if (b.net == net) {
+            if (multi) {
+                b = bound_extra[wire]->back();
+                bound_extra[wire]->pop_back();
+            } else {
+                b = WireBinding();
+            }
+        } else {
+            NPNR_ASSERT(multi);
+            auto &extra = *bound_extra[wire];
+            auto found = std::find_if(extra.begin(), extra.end(), [net](const WireBinding &eb) { return eb.net == net; });
+            NPNR_ASSERT(found != extra.end());
+            *found = extra.back();
+            extra.pop_back();
+        }
+        if (multi && bound_extra[wire]->empty())
+            wire_flags[wire] &= ~WIRE_MULTI_BOUND;
+    }
+
+    float present_wire_cost(int wire, int net_uid)
+    {
+        int other_sources = bound_count(wire);
+        if (is_bound(wire, net_uid))
             other_sources -= 1;
         if (other_sources == 0)
             return 1.0f;
@@ -115,6 +212,17 @@ struct Router2
 
     Router2(Context *ctx, const Router2Cfg &cfg) : ctx(ctx), cfg(cfg) {}
 
+    // Threads for routing partitions, high-fanout clusters and binding, started when first needed and kept until
+    // routing finishes. Only run from the main routing thread, never from inside its own tasks.
+    std::unique_ptr<TaskPool> task_pool;
+
+    TaskPool &get_pool()
+    {
+        if (!task_pool)
+            task_pool.reset(new TaskPool(cfg.threads));
+        return *task_pool;
+    }
+
     // Use 'udata' for fast net lookups and indexing
     std::vector<NetInfo *> nets_by_udata;
     std::vector<PerNetData> nets;
@@ -123,6 +231,23 @@ struct Router2
 
     // Criticality data from timing analysis
     NetCriticalityMap net_crit;
+    // Timing graph kept between iterations. Routes only reach the Arch, and so change net delays, when they are
+    // bound; so the nets routed since the last binding are those that need updating after the next one
+    std::unique_ptr<TimingGraph> timing_graph;
+    std::vector<uint8_t> routed_since_bind;
+    std::vector<NetInfo *> timing_dirty;
+
+    void update_criticalities()
+    {
+        if (!timing_graph) {
+            timing_graph.reset(new TimingGraph(ctx));
+            timing_graph->update_all();
+        } else {
+            timing_graph->update_nets(timing_dirty);
+        }
+        timing_dirty.clear();
+        timing_graph->get_criticalities(&net_crit);
+    }
 
     void setup_nets()
     {
@@ -193,31 +318,51 @@ struct Router2
         }
     }
 
+#ifdef ARCH_XILINX
+    // The chipdb provides a dense wire index directly, avoiding a hash lookup for every pip explored
+    int wire_index(WireId w) const { return ctx->getWireIndex(w); }
+#else
     dict<WireId, int> wire_to_idx;
-    std::vector<PerWireData> flat_wires;
 
-    PerWireData &wire_data(WireId w) { return flat_wires[wire_to_idx.at(w)]; }
+    int wire_index(WireId w) const { return wire_to_idx.at(w); }
+#endif
 
     void setup_wires()
     {
         // Set up per-wire structures, so that MT parts don't have to do any memory allocation
-        // This is possibly quite wasteful and not cache-optimal; further consideration necessary
+#ifdef ARCH_XILINX
+        wire_ids.reserve(ctx->getNumWires());
+        wire_loc.reserve(ctx->getNumWires());
+#endif
         for (auto wire : ctx->getWires()) {
-            PerWireData pwd;
-            pwd.w = wire;
-            NetInfo *bound = ctx->getBoundWireNet(wire);
+            int idx = int(wire_ids.size());
+            wire_ids.push_back(wire);
+#ifdef ARCH_XILINX
+            // getWires() enumerates wires in flat index order
+            NPNR_ASSERT(ctx->getWireIndex(wire) == idx);
+#else
+            wire_to_idx[wire] = idx;
+#endif
+            ArcBounds wire_loc_bb = ctx->getRouteBoundingBox(wire, wire);
+            wire_loc.emplace_back((wire_loc_bb.x0 + wire_loc_bb.x1) / 2, (wire_loc_bb.y0 + wire_loc_bb.y1) / 2);
+        }
+        int num_wires = int(wire_ids.size());
+        wire_flags.resize(num_wires, 0);
+        visit_cost.resize(num_wires, 0);
+        visit_pip.resize(num_wires);
+        hist_cong_cost.resize(num_wires, 1.0f);
+        reserved_net.resize(num_wires, -1);
+        wire_bound.resize(num_wires);
+        bound_extra.resize(num_wires);
+        for (int i = 0; i < num_wires; i++) {
+            NetInfo *bound = ctx->getBoundWireNet(wire_ids[i]);
             if (bound != nullptr) {
-                pwd.bound_nets[bound->udata] = std::make_pair(1, bound->wires.at(wire).pip);
-                if (bound->wires.at(wire).strength > STRENGTH_STRONG)
-                    pwd.unavailable = true;
+                auto &b = add_binding(i, bound->udata);
+                b.uses = 1;
+                b.pip = bound->wires.at(wire_ids[i]).pip;
+                if (bound->wires.at(wire_ids[i]).strength > STRENGTH_STRONG)
+                    wire_flags[i] |= WIRE_UNAVAILABLE;
             }
-
-            ArcBounds wire_loc = ctx->getRouteBoundingBox(wire, wire);
-            pwd.x = (wire_loc.x0 + wire_loc.x1) / 2;
-            pwd.y = (wire_loc.y0 + wire_loc.y1) / 2;
-
-            wire_to_idx[wire] = int(flat_wires.size());
-            flat_wires.push_back(pwd);
         }
     }
 
@@ -249,6 +394,30 @@ struct Router2
 
     double curr_cong_weight, hist_cong_weight, estimate_weight;
 
+    // Search statistics, kept per thread context and summed into the totals for each iteration
+    struct RouteCounters
+    {
+        int64_t arcs = 0, explored = 0, pushes = 0, pops = 0;
+        // Arcs routed by the iteration-limited backwards search, and the iterations it took in total
+        int64_t bwd_success = 0, bwd_iters = 0;
+        // Arcs that could not be routed within their bounding box
+        int64_t bb_failures = 0;
+        // Seconds spent routing nets
+        double busy_time = 0;
+
+        void add(const RouteCounters &other)
+        {
+            arcs += other.arcs;
+            explored += other.explored;
+            pushes += other.pushes;
+            pops += other.pops;
+            bwd_success += other.bwd_success;
+            bwd_iters += other.bwd_iters;
+            bb_failures += other.bb_failures;
+            busy_time += other.busy_time;
+        }
+    };
+
     struct ThreadContext
     {
         // Nets to route
@@ -258,7 +427,7 @@ struct Router2
 
         std::vector<int> route_arcs;
 
-        std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> queue;
+        RouteQueue<QueuedWire, QueuedWire::Greater> queue;
         // Special case where one net has multiple logical arcs to the same physical sink
         pool<WireId> processed_sinks;
 
@@ -271,11 +440,14 @@ struct Router2
         ArcBounds bb;
 
         DeterministicRNG rng;
+
+        RouteCounters counters;
     };
 
-    bool thread_test_wire(ThreadContext &t, PerWireData &w)
+    bool thread_test_wire(ThreadContext &t, int wire)
     {
-        return w.x >= t.bb.x0 && w.x <= t.bb.x1 && w.y >= t.bb.y0 && w.y <= t.bb.y1;
+        auto &l = wire_loc[wire];
+        return l.first >= t.bb.x0 && l.first <= t.bb.x1 && l.second >= t.bb.y0 && l.second <= t.bb.y1;
     }
 
     enum ArcRouteResult
@@ -301,21 +473,24 @@ struct Router2
 
     void bind_pip_internal(NetInfo *net, size_t user, int wire, PipId pip)
     {
-        auto &b = flat_wires.at(wire).bound_nets[net->udata];
-        ++b.first;
-        if (b.first == 1) {
-            b.second = pip;
+        WireBinding *b = find_binding(wire, net->udata);
+        if (b == nullptr)
+            b = &add_binding(wire, net->udata);
+        ++b->uses;
+        if (b->uses == 1) {
+            b->pip = pip;
         } else {
-            NPNR_ASSERT(b.second == pip);
+            NPNR_ASSERT(b->pip == pip);
         }
     }
 
-    void unbind_pip_internal(NetInfo *net, size_t user, WireId wire)
+    void unbind_pip_internal(NetInfo *net, size_t user, int wire)
     {
-        auto &b = wire_data(wire).bound_nets.at(net->udata);
-        --b.first;
-        if (b.first == 0) {
-            wire_data(wire).bound_nets.erase(net->udata);
+        WireBinding *b = find_binding(wire, net->udata);
+        NPNR_ASSERT(b != nullptr);
+        --b->uses;
+        if (b->uses == 0) {
+            remove_binding(wire, net->udata);
         }
     }
 
@@ -327,31 +502,34 @@ struct Router2
         WireId src = nets.at(net->udata).src_wire;
         WireId cursor = ad.sink_wire;
         while (cursor != src) {
-            auto &wd = wire_data(cursor);
-            PipId pip = wd.bound_nets.at(net->udata).second;
-            unbind_pip_internal(net, user, cursor);
+            int cursor_idx = wire_index(cursor);
+            WireBinding *b = find_binding(cursor_idx, net->udata);
+            NPNR_ASSERT(b != nullptr);
+            PipId pip = b->pip;
+            unbind_pip_internal(net, user, cursor_idx);
             cursor = ctx->getPipSrcWire(pip);
         }
         ad.routed = false;
     }
 
-    float score_wire_for_arc(NetInfo *net, size_t user, WireId wire, PipId pip)
+    float score_wire_for_arc(NetInfo *net, size_t user, int wire, PipId pip)
     {
-        auto &wd = wire_data(wire);
         auto &nd = nets.at(net->udata);
-        float base_cost = ctx->getDelayNS(ctx->getPipDelay(pip).maxDelay() + ctx->getWireDelay(wire).maxDelay() +
-                                          ctx->getDelayEpsilon());
-        float present_cost = present_wire_cost(wd, net->udata);
-        float hist_cost = wd.hist_cong_cost;
+        float base_cost = ctx->getDelayNS(ctx->getPipDelay(pip).maxDelay() +
+                                          ctx->getWireDelay(wire_ids[wire]).maxDelay() + ctx->getDelayEpsilon());
+        float present_cost = present_wire_cost(wire, net->udata);
+        float hist_cost = hist_cong_cost[wire];
         float bias_cost = 0;
         int source_uses = 0;
-        if (wd.bound_nets.count(net->udata))
-            source_uses = wd.bound_nets.at(net->udata).first;
+        WireBinding *b = find_binding(wire, net->udata);
+        if (b != nullptr)
+            source_uses = b->uses;
         if (timing_driven) {
             float max_bound_crit = 0;
-            for (auto &bound : wd.bound_nets)
-                if (bound.first != net->udata)
-                    max_bound_crit = std::max(max_bound_crit, nets.at(bound.first).max_crit);
+            for_each_binding(wire, [&](const WireBinding &bound) {
+                if (bound.net != net->udata)
+                    max_bound_crit = std::max(max_bound_crit, nets.at(bound.net).max_crit);
+            });
             if (max_bound_crit >= 0.8 && nd.arcs.at(user).arc_crit < (max_bound_crit + 0.01)) {
                 present_cost *= 1.5;
             }
@@ -366,12 +544,12 @@ struct Router2
 
     float get_togo_cost(NetInfo *net, size_t user, int wire, WireId sink)
     {
-        auto &wd = flat_wires[wire];
         int source_uses = 0;
-        if (wd.bound_nets.count(net->udata))
-            source_uses = wd.bound_nets.at(net->udata).first;
+        WireBinding *b = find_binding(wire, net->udata);
+        if (b != nullptr)
+            source_uses = b->uses;
         // FIXME: timing/wirelength balance?
-        return (ctx->getDelayNS(ctx->estimateDelay(wd.w, sink)) / (1 + source_uses)) + cfg.ipin_cost_adder;
+        return (ctx->getDelayNS(ctx->estimateDelay(wire_ids[wire], sink)) / (1 + source_uses)) + cfg.ipin_cost_adder;
     }
 
     bool check_arc_routing(NetInfo *net, size_t usr)
@@ -379,18 +557,99 @@ struct Router2
         auto &ad = nets.at(net->udata).arcs.at(usr);
         WireId src_wire = nets.at(net->udata).src_wire;
         WireId cursor = ad.sink_wire;
-        while (wire_data(cursor).bound_nets.count(net->udata)) {
-            auto &wd = wire_data(cursor);
-            if (wd.bound_nets.size() != 1)
+        while (true) {
+            int cursor_idx = wire_index(cursor);
+            WireBinding *b = find_binding(cursor_idx, net->udata);
+            if (b == nullptr)
+                break;
+            if (bound_count(cursor_idx) != 1)
                 return false;
-            auto &uh = wd.bound_nets.at(net->udata).second;
-            if (uh == PipId())
+            if (b->pip == PipId())
                 break;
-            cursor = ctx->getPipSrcWire(uh);
+            cursor = ctx->getPipSrcWire(b->pip);
         }
         return (cursor == src_wire);
     }
 
+    // Find the existing route of an arc through the nextpnr wire bindings of the net, from sink back to source, as
+    // (wire, driving pip) pairs. Returns false if the route is incomplete, for example because an endpoint moved
+    bool existing_arc_route(NetInfo *net, size_t usr, std::vector<std::pair<int, PipId>> &path)
+    {
+        WireId src_wire = nets.at(net->udata).src_wire;
+        WireId cursor = nets.at(net->udata).arcs.at(usr).sink_wire;
+        path.clear();
+        while (cursor != src_wire) {
+            auto fnd = net->wires.find(cursor);
+            if (fnd == net->wires.end() || fnd->second.pip == PipId())
+                return false;
+            PipId pip = fnd->second.pip;
+            // Guard against loops in a corrupt route
+            if (ctx->getPipDstWire(pip) != cursor || path.size() > net->wires.size())
+                return false;
+            path.emplace_back(wire_index(cursor), pip);
+            cursor = ctx->getPipSrcWire(pip);
+        }
+        if (!net->wires.count(src_wire))
+            return false;
+        path.emplace_back(wire_index(src_wire), PipId());
+        return true;
+    }
+
+    // Incremental mode: keep the existing routing of arcs that are still complete, and only queue nets that have
+    // arcs that are not. The nextpnr bindings of queued nets are released so they don't block their own reroute
+    void seed_existing_routing()
+    {
+        int kept_arcs = 0, total_arcs = 0;
+        std::vector<std::pair<int, PipId>> path;
+        std::vector<WireId> net_wires;
+        for (auto net : nets_by_udata) {
+            auto &nd = nets.at(net->udata);
+            // setup_wires gave every bound wire one use; rebuild the bindings from the complete arcs instead, so
+            // that wires shared between arcs have the right use count and stubs are dropped
+            for (auto &w : net->wires) {
+                if (w.second.strength > STRENGTH_STRONG)
+                    continue;
+                int idx = wire_index(w.first);
+                if (find_binding(idx, net->udata) != nullptr)
+                    remove_binding(idx, net->udata);
+            }
+            if (net->driver.cell == nullptr)
+                continue;
+            bool need_route = false;
+            for (size_t i = 0; i < net->users.size(); i++) {
+                auto &ad = nd.arcs.at(i);
+                if (ad.sink_wire == WireId())
+                    continue;
+                ++total_arcs;
+                auto fnd = net->wires.find(ad.sink_wire);
+                if (ad.sink_wire == nd.src_wire || (fnd != net->wires.end() && fnd->second.strength > STRENGTH_STRONG)) {
+                    // Nothing to route, or locked routing that route_net leaves alone anyway
+                    ++kept_arcs;
+                    continue;
+                }
+                if (!existing_arc_route(net, i, path)) {
+                    need_route = true;
+                    continue;
+                }
+                for (auto &p : path)
+                    bind_pip_internal(net, i, p.first, p.second);
+                ad.routed = true;
+                ++kept_arcs;
+            }
+            if (need_route) {
+                route_queue.push_back(net->udata);
+                net_wires.clear();
+                for (auto &w : net->wires)
+                    if (w.second.strength <= STRENGTH_STRONG)
+                        net_wires.push_back(w.first);
+                for (auto w : net_wires)
+                    ctx->unbindWire(w);
+            }
+        }
+        log_info("Keeping existing routing for %d/%d arcs, rerouting %d/%d nets.\n", kept_arcs, total_arcs,
+                 int(route_queue.size()), int(nets_by_udata.size()));
+    }
+
     // Returns true if a wire contains no source ports or driving pips
     bool is_wire_undriveable(WireId wire, const NetInfo *net, int iter_count = 0)
     {
@@ -403,7 +662,8 @@ struct Router2
         // and LUT
         if (iter_count > 0)
             return false; // heuristic to assume we've hit general routing
-        if (wire_data(wire).reserved_net != -1 && wire_data(wire).reserved_net != net->udata)
+        int wire_idx = wire_index(wire);
+        if (reserved_net[wire_idx] != -1 && reserved_net[wire_idx] != net->udata)
             return true; // reserved for another net
         for (auto bp : ctx->getWireBelPins(wire))
             if ((net->driver.cell == nullptr || bp.bel == net->driver.cell->bel) &&
@@ -431,11 +691,11 @@ struct Router2
         if (ctx->debug)
             log("resevering wires for arc %d of net %s\n", int(i), ctx->nameOf(net));
         while (!done) {
-            auto &wd = wire_data(cursor);
+            int cursor_idx = wire_index(cursor);
             if (ctx->debug)
                 log("      %s\n", ctx->nameOfWire(cursor));
-            did_something |= (wd.reserved_net != net->udata);
-            wd.reserved_net = net->udata;
+            did_something |= (reserved_net[cursor_idx] != net->udata);
+            reserved_net[cursor_idx] = net->udata;
             if (cursor == src)
                 break;
             WireId next_cursor;
@@ -475,25 +735,23 @@ struct Router2
     void reset_wires(ThreadContext &t)
     {
         for (auto w : t.dirty_wires) {
-            flat_wires[w].visit.visited = false;
-            flat_wires[w].visit.dirty = false;
-            flat_wires[w].visit.pip = PipId();
-            flat_wires[w].visit.score = WireScore();
+            wire_flags[w] &= ~(WIRE_VISITED | WIRE_DIRTY);
+            visit_pip[w] = PipId();
+            visit_cost[w] = 0;
         }
         t.dirty_wires.clear();
     }
 
     void set_visited(ThreadContext &t, int wire, PipId pip, WireScore score)
     {
-        auto &v = flat_wires.at(wire).visit;
-        if (!v.dirty)
+        if (!(wire_flags[wire] & WIRE_DIRTY))
             t.dirty_wires.push_back(wire);
-        v.dirty = true;
-        v.visited = true;
-        v.pip = pip;
-        v.score = score;
+        wire_flags[wire] |= (WIRE_VISITED | WIRE_DIRTY);
+        ++t.counters.explored;
+        visit_pip[wire] = pip;
+        visit_cost[wire] = score.total();
     }
-    bool was_visited(int wire) { return flat_wires.at(wire).visit.visited; }
+    bool was_visited(int wire) { return wire_flags[wire] & WIRE_VISITED; }
 
 #ifdef ARCH_XILINX
     // Special-case constant ground/vcc routing for Xilinx devices
@@ -518,55 +776,56 @@ struct Router2
                 std::queue<int> new_queue;
                 t.backwards_queue.swap(new_queue);
             }
-            t.backwards_queue.push(wire_to_idx.at(dst_wire));
+            t.backwards_queue.push(wire_index(dst_wire));
             reset_wires(t);
             while (!t.backwards_queue.empty() && backwards_iter < backwards_limit) {
                 int cursor = t.backwards_queue.front();
                 t.backwards_queue.pop();
-                auto &cwd = flat_wires[cursor];
+                WireId cursor_wire = wire_ids[cursor];
                 PipId cpip;
-                if (cwd.bound_nets.count(net->udata)) {
+                WireBinding *cb = find_binding(cursor, net->udata);
+                if (cb != nullptr) {
                     // If we can tack onto existing routing; try that
                     // Only do this if the existing routing is uncontented; however
                     int cursor2 = cursor;
                     bool bwd_merge_fail = false;
-                    while (flat_wires.at(cursor2).bound_nets.count(net->udata)) {
-                        if (int(flat_wires.at(cursor2).bound_nets.size()) > (allowed_cong + 1)) {
+                    while (WireBinding *b2 = find_binding(cursor2, net->udata)) {
+                        if (bound_count(cursor2) > (allowed_cong + 1)) {
                             bwd_merge_fail = true;
                             break;
                         }
-                        PipId p = flat_wires.at(cursor2).bound_nets.at(net->udata).second;
+                        PipId p = b2->pip;
                         if (p == PipId())
                             break;
-                        cursor2 = wire_to_idx.at(ctx->getPipSrcWire(p));
+                        cursor2 = wire_index(ctx->getPipSrcWire(p));
                     }
                     if (!bwd_merge_fail && cursor2 == src_wire_idx) {
                         // Found a path to merge to existing routing; backwards
                         cursor2 = cursor;
-                        while (flat_wires.at(cursor2).bound_nets.count(net->udata)) {
-                            PipId p = flat_wires.at(cursor2).bound_nets.at(net->udata).second;
+                        while (WireBinding *b2 = find_binding(cursor2, net->udata)) {
+                            PipId p = b2->pip;
                             if (p == PipId())
                                 break;
-                            cursor2 = wire_to_idx.at(ctx->getPipSrcWire(p));
+                            cursor2 = wire_index(ctx->getPipSrcWire(p));
                             set_visited(t, cursor2, p, WireScore());
                         }
                         break;
                     }
-                    cpip = cwd.bound_nets.at(net->udata).second;
+                    cpip = cb->pip;
                 }
 #if 0
-                log("   explore %s\n", ctx->nameOfWire(cwd.w));
+                log("   explore %s\n", ctx->nameOfWire(cursor_wire));
 #endif
-                if (ctx->wireIntent(cwd.w) == (const_val ? ID_PSEUDO_VCC : ID_PSEUDO_GND)) {
+                if (ctx->wireIntent(cursor_wire) == (const_val ? ID_PSEUDO_VCC : ID_PSEUDO_GND)) {
 #if 0
-                    log("    Hit global network at %s\n", ctx->nameOfWire(cwd.w));
+                    log("    Hit global network at %s\n", ctx->nameOfWire(cursor_wire));
 #endif
                     // We've hit the constant pseudo-network, continue from here
                     int cursor2 = cursor;
                     while (cursor2 != src_wire_idx) {
-                        auto &c2wd = flat_wires.at(cursor2);
+                        WireId cursor2_wire = wire_ids[cursor2];
                         bool found = false;
-                        for (auto p : ctx->getPipsUphill(c2wd.w)) {
+                        for (auto p : ctx->getPipsUphill(cursor2_wire)) {
                             if (!ctx->checkPipAvail(p) && ctx->getBoundPipNet(p) != net)
                                 continue;
                             WireId src = ctx->getPipSrcWire(p);
@@ -574,42 +833,42 @@ struct Router2
                                 continue;
                             if (is_wire_undriveable(src, net))
                                 continue;
-                            cursor2 = wire_to_idx.at(src);
+                            cursor2 = wire_index(src);
                             set_visited(t, cursor2, p, WireScore());
                             found = true;
                             break;
                         }
                         if (!found)
-                            log_error("Invalid global constant node '%s'\n", ctx->nameOfWire(c2wd.w));
+                            log_error("Invalid global constant node '%s'\n", ctx->nameOfWire(cursor2_wire));
                     }
 
                     break;
                 }
 #if 0
-                std::string name = ctx->nameOfWire(cwd.w);
+                std::string name = ctx->nameOfWire(cursor_wire);
                 if (name.substr(int(name.size()) - 3) == "A_O") {
-                    for (auto uh : ctx->getPipsUphill(flat_wires[cursor].w)) {
-                        log("   %s <-- %s %d\n", ctx->nameOfWire(flat_wires[cursor].w), ctx->nameOfWire(ctx->getPipSrcWire(uh)), int(!ctx->checkPipAvail(uh) && ctx->getBoundPipNet(uh) != net));
+                    for (auto uh : ctx->getPipsUphill(cursor_wire)) {
+                        log("   %s <-- %s %d\n", ctx->nameOfWire(cursor_wire), ctx->nameOfWire(ctx->getPipSrcWire(uh)), int(!ctx->checkPipAvail(uh) && ctx->getBoundPipNet(uh) != net));
                     }
                 }
 #endif
                 bool did_something = false;
-                for (auto uh : ctx->getPipsUphill(flat_wires[cursor].w)) {
+                for (auto uh : ctx->getPipsUphill(cursor_wire)) {
                     did_something = true;
                     if (!ctx->checkPipAvail(uh) && ctx->getBoundPipNet(uh) != net)
                         continue;
                     if (cpip != PipId() && cpip != uh)
                         continue; // don't allow multiple pips driving a wire with a net
-                    int next = wire_to_idx.at(ctx->getPipSrcWire(uh));
+                    int next = wire_index(ctx->getPipSrcWire(uh));
                     if (was_visited(next))
                         continue; // skip wires that have already been visited
-                    auto &wd = flat_wires[next];
-                    if (wd.unavailable)
+                    if (wire_flags[next] & WIRE_UNAVAILABLE)
                         continue;
-                    if (wd.reserved_net != -1 && wd.reserved_net != net->udata)
+                    if (reserved_net[next] != -1 && reserved_net[next] != net->udata)
                         continue;
-                    if (int(wd.bound_nets.size()) > (allowed_cong + 1) ||
-                        (allowed_cong == 0 && wd.bound_nets.size() == 1 && !wd.bound_nets.count(net->udata)))
+                    int next_bound = bound_count(next);
+                    if (next_bound > (allowed_cong + 1) ||
+                        (allowed_cong == 0 && next_bound == 1 && !is_bound(next, net->udata)))
                         continue; // never allow congestion in backwards routing
                     t.backwards_queue.push(next);
                     set_visited(t, next, uh, WireScore());
@@ -617,19 +876,18 @@ struct Router2
                 if (did_something)
                     ++backwards_iter;
             }
-            int dst_wire_idx = wire_to_idx.at(dst_wire);
+            int dst_wire_idx = wire_index(dst_wire);
             if (was_visited(src_wire_idx)) {
                 ROUTE_LOG_DBG("   Routed (backwards): ");
                 int cursor_fwd = src_wire_idx;
                 bind_pip_internal(net, i, src_wire_idx, PipId());
                 while (was_visited(cursor_fwd)) {
-                    auto &v = flat_wires.at(cursor_fwd).visit;
-                    cursor_fwd = wire_to_idx.at(ctx->getPipDstWire(v.pip));
-                    bind_pip_internal(net, i, cursor_fwd, v.pip);
+                    PipId v_pip = visit_pip[cursor_fwd];
+                    cursor_fwd = wire_index(ctx->getPipDstWire(v_pip));
+                    bind_pip_internal(net, i, cursor_fwd, v_pip);
                     if (ctx->debug) {
-                        auto &wd = flat_wires.at(cursor_fwd);
-                        ROUTE_LOG_DBG("      wire: %s (curr %d hist %f)\n", ctx->nameOfWire(wd.w),
-                                      int(wd.bound_nets.size()) - 1, wd.hist_cong_cost);
+                        ROUTE_LOG_DBG("      wire: %s (curr %d hist %f)\n", ctx->nameOfWire(wire_ids[cursor_fwd]),
+                                      bound_count(cursor_fwd) - 1, hist_cong_cost[cursor_fwd]);
                     }
                 }
                 NPNR_ASSERT(cursor_fwd == dst_wire_idx);
@@ -659,11 +917,12 @@ struct Router2
         if (dst_wire == WireId())
             ARC_LOG_ERR("No wire found for port %s on destination cell %s.\n", ctx->nameOf(usr.port),
                         ctx->nameOf(usr.cell));
-        int src_wire_idx = wire_to_idx.at(src_wire);
-        int dst_wire_idx = wire_to_idx.at(dst_wire);
+        int src_wire_idx = wire_index(src_wire);
+        int dst_wire_idx = wire_index(dst_wire);
         // Check if arc was already done _in this iteration_
         if (t.processed_sinks.count(dst_wire))
             return ARC_SUCCESS;
+        ++t.counters.arcs;
 
             // Special case
 #ifdef ARCH_XILINX
@@ -673,10 +932,7 @@ struct Router2
         }
 #endif
 
-        if (!t.queue.empty()) {
-            std::priority_queue<QueuedWire, std::vector<QueuedWire>, QueuedWire::Greater> new_queue;
-            t.queue.swap(new_queue);
-        }
+        t.queue.clear();
         if (!t.backwards_queue.empty()) {
             std::queue<int> new_queue;
             t.backwards_queue.swap(new_queue);
@@ -690,55 +946,55 @@ struct Router2
         int backwards_limit = ctx->getBelGlobalBuf(net->driver.cell->bel)
                                       ? cfg.global_backwards_max_iter
                                       : (net->users.size() > 40 ? 20 * cfg.backwards_max_iter : cfg.backwards_max_iter);
-        t.backwards_queue.push(wire_to_idx.at(dst_wire));
+        t.backwards_queue.push(dst_wire_idx);
         while (!t.backwards_queue.empty() && backwards_iter < backwards_limit) {
             int cursor = t.backwards_queue.front();
             t.backwards_queue.pop();
-            auto &cwd = flat_wires[cursor];
             PipId cpip;
-            if (cwd.bound_nets.count(net->udata)) {
+            WireBinding *cb = find_binding(cursor, net->udata);
+            if (cb != nullptr) {
                 // If we can tack onto existing routing; try that
                 // Only do this if the existing routing is uncontented; however
                 int cursor2 = cursor;
                 bool bwd_merge_fail = false;
-                while (flat_wires.at(cursor2).bound_nets.count(net->udata)) {
-                    PipId p = flat_wires.at(cursor2).bound_nets.at(net->udata).second;
+                while (WireBinding *b2 = find_binding(cursor2, net->udata)) {
+                    PipId p = b2->pip;
                     if (p == PipId())
                         break;
-                    cursor2 = wire_to_idx.at(ctx->getPipSrcWire(p));
+                    cursor2 = wire_index(ctx->getPipSrcWire(p));
                 }
                 if (!bwd_merge_fail && cursor2 == src_wire_idx) {
                     // Found a path to merge to existing routing; backwards
                     cursor2 = cursor;
-                    while (flat_wires.at(cursor2).bound_nets.count(net->udata)) {
-                        PipId p = flat_wires.at(cursor2).bound_nets.at(net->udata).second;
+                    while (WireBinding *b2 = find_binding(cursor2, net->udata)) {
+                        PipId p = b2->pip;
                         if (p == PipId())
                             break;
-                        cursor2 = wire_to_idx.at(ctx->getPipSrcWire(p));
+                        cursor2 = wire_index(ctx->getPipSrcWire(p));
                         set_visited(t, cursor2, p, WireScore());
                     }
                     break;
                 }
-                cpip = cwd.bound_nets.at(net->udata).second;
+                cpip = cb->pip;
             }
             bool did_something = false;
-            for (auto uh : ctx->getPipsUphill(flat_wires[cursor].w)) {
+            for (auto uh : ctx->getPipsUphill(wire_ids[cursor])) {
                 did_something = true;
                 if (!ctx->checkPipAvail(uh) && ctx->getBoundPipNet(uh) != net)
                     continue;
                 if (cpip != PipId() && cpip != uh)
                     continue; // don't allow multiple pips driving a wire with a net
-                int next = wire_to_idx.at(ctx->getPipSrcWire(uh));
+                int next = wire_index(ctx->getPipSrcWire(uh));
                 if (was_visited(next))
                     continue; // skip wires that have already been visited
-                auto &wd = flat_wires[next];
-                if (wd.unavailable)
+                if (wire_flags[next] & WIRE_UNAVAILABLE)
                     continue;
-                if (wd.reserved_net != -1 && wd.reserved_net != net->udata)
+                if (reserved_net[next] != -1 && reserved_net[next] != net->udata)
                     continue;
-                if (wd.bound_nets.size() > 1 || (wd.bound_nets.size() == 1 && !wd.bound_nets.count(net->udata)))
+                int next_bound = bound_count(next);
+                if (next_bound > 1 || (next_bound == 1 && !is_bound(next, net->udata)))
                     continue; // never allow congestion in backwards routing
-                if (!thread_test_wire(t, wd))
+                if (!thread_test_wire(t, next))
                     continue; // thread safety issue
                 t.backwards_queue.push(next);
                 set_visited(t, next, uh, WireScore());
@@ -746,19 +1002,20 @@ struct Router2
             if (did_something)
                 ++backwards_iter;
         }
+        t.counters.bwd_iters += backwards_iter;
         // Check if backwards routing succeeded in reaching source
         if (was_visited(src_wire_idx)) {
+            ++t.counters.bwd_success;
             ROUTE_LOG_DBG("   Routed (backwards): ");
             int cursor_fwd = src_wire_idx;
             bind_pip_internal(net, i, src_wire_idx, PipId());
             while (was_visited(cursor_fwd)) {
-                auto &v = flat_wires.at(cursor_fwd).visit;
-                cursor_fwd = wire_to_idx.at(ctx->getPipDstWire(v.pip));
-                bind_pip_internal(net, i, cursor_fwd, v.pip);
+                PipId v_pip = visit_pip[cursor_fwd];
+                cursor_fwd = wire_index(ctx->getPipDstWire(v_pip));
+                bind_pip_internal(net, i, cursor_fwd, v_pip);
                 if (ctx->debug) {
-                    auto &wd = flat_wires.at(cursor_fwd);
-                    ROUTE_LOG_DBG("      wire: %s (curr %d hist %f)\n", ctx->nameOfWire(wd.w),
-                                  int(wd.bound_nets.size()) - 1, wd.hist_cong_cost);
+                    ROUTE_LOG_DBG("      wire: %s (curr %d hist %f)\n", ctx->nameOfWire(wire_ids[cursor_fwd]),
+                                  bound_count(cursor_fwd) - 1, hist_cong_cost[cursor_fwd]);
                 }
             }
             NPNR_ASSERT(cursor_fwd == dst_wire_idx);
@@ -776,7 +1033,7 @@ struct Router2
         base_score.togo_cost = get_togo_cost(net, i, src_wire_idx, dst_wire);
 
         // Add source wire to queue
-        t.queue.push(QueuedWire(src_wire_idx, PipId(), Loc(), base_score));
+        t.queue.push(QueuedWire(src_wire_idx, PipId(), Loc(), base_score), base_score.total());
         set_visited(t, src_wire_idx, PipId(), base_score);
 
         int toexplore = 250000 * std::max(1, (ad.bb.x1 - ad.bb.x0) + (ad.bb.y1 - ad.bb.y0));
@@ -798,14 +1055,14 @@ struct Router2
         bool must_drain_queue = !is_bb;
         while (!t.queue.empty() && (must_drain_queue || iter < toexplore)) {
             auto curr = t.queue.top();
-            auto &d = flat_wires.at(curr.wire);
+            WireId curr_wire = wire_ids[curr.wire];
             t.queue.pop();
             ++iter;
 #if 0
             ROUTE_LOG_DBG("current wire %s\n", ctx->nameOfWire(curr.wire));
 #endif
             // Explore all pips downhill of cursor
-            for (auto dh : ctx->getPipsDownhill(d.w)) {
+            for (auto dh : ctx->getPipsDownhill(curr_wire)) {
                 // Skip pips outside of box in bounding-box mode
 #if 0
                 ROUTE_LOG_DBG("trying pip %s\n", ctx->nameOfPip(dh));
@@ -822,36 +1079,35 @@ struct Router2
 #endif
                 // Evaluate score of next wire
                 WireId next = ctx->getPipDstWire(dh);
-                int next_idx = wire_to_idx.at(next);
+                int next_idx = wire_index(next);
                 if (was_visited(next_idx))
                     continue;
 #if 1
                 if (debug_arc)
                     ROUTE_LOG_DBG("   src wire %s\n", ctx->nameOfWire(next));
 #endif
-                auto &nwd = flat_wires.at(next_idx);
-                if (nwd.unavailable)
+                if (wire_flags[next_idx] & WIRE_UNAVAILABLE)
                     continue;
-                if (nwd.reserved_net != -1 && nwd.reserved_net != net->udata)
+                if (reserved_net[next_idx] != -1 && reserved_net[next_idx] != net->udata)
                     continue;
-                if (nwd.bound_nets.count(net->udata) && nwd.bound_nets.at(net->udata).second != dh)
+                WireBinding *nb = find_binding(next_idx, net->udata);
+                if (nb != nullptr && nb->pip != dh)
                     continue;
-                if (!thread_test_wire(t, nwd))
+                if (!thread_test_wire(t, next_idx))
                     continue; // thread safety issue
                 WireScore next_score;
-                next_score.cost = curr.score.cost + score_wire_for_arc(net, i, next, dh);
+                next_score.cost = curr.score.cost + score_wire_for_arc(net, i, next_idx, dh);
                 next_score.delay =
                         curr.score.delay + ctx->getPipDelay(dh).maxDelay() + ctx->getWireDelay(next).maxDelay();
                 next_score.togo_cost = cfg.estimate_weight * get_togo_cost(net, i, next_idx, dst_wire);
-                const auto &v = nwd.visit;
-                if (!v.visited || (v.score.total() > next_score.total())) {
+                if (!was_visited(next_idx) || (visit_cost[next_idx] > next_score.total())) {
                     ++explored;
 #if 0
                     ROUTE_LOG_DBG("exploring wire %s cost %f togo %f\n", ctx->nameOfWire(next), next_score.cost,
                                   next_score.togo_cost);
 #endif
                     // Add wire to queue if it meets criteria
-                    t.queue.push(QueuedWire(next_idx, dh, ctx->getPipLocation(dh), next_score, t.rng.rng()));
+                    t.queue.push(QueuedWire(next_idx, dh, ctx->getPipLocation(dh), next_score, t.rng.rng()), next_score.total());
                     set_visited(t, next_idx, dh, next_score);
                     if (next == dst_wire) {
                         toexplore = std::min(toexplore, iter + 5);
@@ -860,25 +1116,27 @@ struct Router2
                 }
             }
         }
+        t.counters.pops += iter;
+        t.counters.pushes += explored;
         if (was_visited(dst_wire_idx)) {
             ROUTE_LOG_DBG("   Routed (explored %d wires): ", explored);
             int cursor_bwd = dst_wire_idx;
             while (was_visited(cursor_bwd)) {
-                auto &v = flat_wires.at(cursor_bwd).visit;
-                bind_pip_internal(net, i, cursor_bwd, v.pip);
+                PipId v_pip = visit_pip[cursor_bwd];
+                bind_pip_internal(net, i, cursor_bwd, v_pip);
                 if (ctx->debug) {
-                    auto &wd = flat_wires.at(cursor_bwd);
-                    ROUTE_LOG_DBG("      wire: %s (curr %d hist %f share %d)\n", ctx->nameOfWire(wd.w),
-                                  int(wd.bound_nets.size()) - 1, wd.hist_cong_cost,
-                                  wd.bound_nets.count(net->udata) ? wd.bound_nets.at(net->udata).first : 0);
+                    WireBinding *b = find_binding(cursor_bwd, net->udata);
+                    ROUTE_LOG_DBG("      wire: %s (curr %d hist %f share %d)\n",
+                                  ctx->nameOfWire(wire_ids[cursor_bwd]), bound_count(cursor_bwd) - 1,
+                                  hist_cong_cost[cursor_bwd], b ? b->uses : 0);
                 }
-                if (v.pip == PipId()) {
+                if (v_pip == PipId()) {
                     NPNR_ASSERT(cursor_bwd == src_wire_idx);
                     break;
                 }
-                ROUTE_LOG_DBG("         pip: %s (%d, %d)\n", ctx->nameOfPip(v.pip), ctx->getPipLocation(v.pip).x,
-                              ctx->getPipLocation(v.pip).y);
-                cursor_bwd = wire_to_idx.at(ctx->getPipSrcWire(v.pip));
+                ROUTE_LOG_DBG("         pip: %s (%d, %d)\n", ctx->nameOfPip(v_pip), ctx->getPipLocation(v_pip).x,
+                              ctx->getPipLocation(v_pip).y);
+                cursor_bwd = wire_index(ctx->getPipSrcWire(v_pip));
             }
             t.processed_sinks.insert(dst_wire);
             ad.routed = true;
@@ -886,11 +1144,236 @@ struct Router2
             return ARC_SUCCESS;
         } else {
             reset_wires(t);
+            ++t.counters.bb_failures;
             return ARC_RETRY_WITHOUT_BB;
         }
     }
 #undef ARC_ERR
 
+    // Arcs of a high-fanout net, routed in parallel within a region of the device that no other cluster of the
+    // net touches
+    struct ArcCluster
+    {
+        ThreadContext tc;
+        std::vector<int> arcs;
+        // Wires of the net's routing within the region, that further arcs can be started from
+        std::vector<int> tree_wires;
+        // For each arc, the wire of the existing routing it was joined onto, or -1 if it wasn't routed
+        std::vector<int> join_wire;
+    };
+
+    void cluster_arcs(std::vector<std::unique_ptr<ArcCluster>> &clusters, NetInfo *net, ArcBounds bb,
+                      std::vector<int> &arcs, int depth, int max_depth)
+    {
+        auto &nd = nets.at(net->udata);
+        auto sink_loc = [&](int i) { return wire_loc.at(wire_index(nd.arcs.at(i).sink_wire)); };
+        // Regions need enough arcs to be worth routing one of them first, serially, to bring the net in
+        const int min_cluster_arcs = 16;
+        if (depth < max_depth && int(arcs.size()) >= 2 * min_cluster_arcs) {
+            int x0 = std::max(bb.x0, nd.bb.x0), y0 = std::max(bb.y0, nd.bb.y0);
+            int x1 = std::min(bb.x1, nd.bb.x1), y1 = std::min(bb.y1, nd.bb.y1);
+            bool split_x = (x1 - x0) >= (y1 - y0);
+            std::vector<int> coords;
+            for (int i : arcs)
+                coords.push_back(split_x ? sink_loc(i).first : sink_loc(i).second);
+            std::nth_element(coords.begin(), coords.begin() + coords.size() / 2, coords.end());
+            int cut = coords.at(coords.size() / 2);
+            std::vector<int> lo_arcs, hi_arcs;
+            for (int i : arcs)
+                ((split_x ? sink_loc(i).first : sink_loc(i).second) <= cut ? lo_arcs : hi_arcs).push_back(i);
+            if (!lo_arcs.empty() && !hi_arcs.empty()) {
+                ArcBounds lo_bb = bb, hi_bb = bb;
+                if (split_x) {
+                    lo_bb.x1 = cut;
+                    hi_bb.x0 = cut + 1;
+                } else {
+                    lo_bb.y1 = cut;
+                    hi_bb.y0 = cut + 1;
+                }
+                cluster_arcs(clusters, net, lo_bb, lo_arcs, depth + 1, max_depth);
+                cluster_arcs(clusters, net, hi_bb, hi_arcs, depth + 1, max_depth);
+                return;
+            }
+        }
+        clusters.emplace_back(new ArcCluster);
+        clusters.back()->tc.bb = bb;
+        clusters.back()->arcs = arcs;
+    }
+
+    // A* search for an arc of a clustered net, starting from all of the net's routing in the cluster's region.
+    // Everything touched is within the region, except the wires upstream of the join point, whose use counts
+    // are left for the caller to update once the clusters are all done
+    bool route_arc_from_tree(ArcCluster &c, NetInfo *net, size_t i, int &join)
+    {
+        auto &t = c.tc;
+        auto &nd = nets[net->udata];
+        auto &ad = nd.arcs[i];
+        WireId dst_wire = ad.sink_wire;
+        int dst_wire_idx = wire_index(dst_wire);
+        join = -1;
+        if (t.processed_sinks.count(dst_wire))
+            return true;
+        if (!thread_test_wire(t, dst_wire_idx))
+            return false;
+        ++t.counters.arcs;
+        t.queue.clear();
+        for (int tree_wire : c.tree_wires) {
+            WireScore base_score;
+            base_score.cost = 0;
+            base_score.delay = 0;
+            base_score.togo_cost = cfg.estimate_weight * get_togo_cost(net, i, tree_wire, dst_wire);
+            t.queue.push(QueuedWire(tree_wire, PipId(), Loc(), base_score, t.rng.rng()), base_score.total());
+            set_visited(t, tree_wire, PipId(), base_score);
+        }
+        t.counters.pushes += c.tree_wires.size();
+
+        int toexplore = 250000 * std::max(1, (ad.bb.x1 - ad.bb.x0) + (ad.bb.y1 - ad.bb.y0));
+        int iter = 0;
+        while (!t.queue.empty() && iter < toexplore && !was_visited(dst_wire_idx)) {
+            auto curr = t.queue.top();
+            WireId curr_wire = wire_ids[curr.wire];
+            t.queue.pop();
+            ++iter;
+            for (auto dh : ctx->getPipsDownhill(curr_wire)) {
+                if (!hit_test_pip(nd.bb, ctx->getPipLocation(dh)))
+                    continue;
+                if (!ctx->checkPipAvail(dh) && ctx->getBoundPipNet(dh) != net)
+                    continue;
+                WireId next = ctx->getPipDstWire(dh);
+                int next_idx = wire_index(next);
+                if (!thread_test_wire(t, next_idx))
+                    continue;
+                if (was_visited(next_idx))
+                    continue;
+                if (wire_flags[next_idx] & WIRE_UNAVAILABLE)
+                    continue;
+                if (reserved_net[next_idx] != -1 && reserved_net[next_idx] != net->udata)
+                    continue;
+                WireBinding *nb = find_binding(next_idx, net->udata);
+                if (nb != nullptr && nb->pip != dh)
+                    continue;
+                WireScore next_score;
+                next_score.cost = curr.score.cost + score_wire_for_arc(net, i, next_idx, dh);
+                next_score.delay =
+                        curr.score.delay + ctx->getPipDelay(dh).maxDelay() + ctx->getWireDelay(next).maxDelay();
+                next_score.togo_cost = cfg.estimate_weight * get_togo_cost(net, i, next_idx, dst_wire);
+                t.queue.push(QueuedWire(next_idx, dh, ctx->getPipLocation(dh), next_score, t.rng.rng()), next_score.total());
+                set_visited(t, next_idx, dh, next_score);
+                ++t.counters.pushes;
+            }
+        }
+        t.counters.pops += iter;
+        if (!was_visited(dst_wire_idx)) {
+            reset_wires(t);
+            ++t.counters.bb_failures;
+            return false;
+        }
+        int cursor = dst_wire_idx;
+        while (visit_pip[cursor] != PipId()) {
+            PipId v_pip = visit_pip[cursor];
+            bind_pip_internal(net, i, cursor, v_pip);
+            c.tree_wires.push_back(cursor);
+            cursor = wire_index(ctx->getPipSrcWire(v_pip));
+        }
+        join = cursor;
+        t.processed_sinks.insert(dst_wire);
+        ad.routed = true;
+        reset_wires(t);
+        return true;
+    }
+
+    // Statistics of routing within clusters, accounted separately as it runs in parallel to the serial pass
+    RouteCounters cluster_counters;
+
+    // Route as many of the arcs in t.route_arcs as possible in parallel, leaving the rest in t.route_arcs
+    void route_net_clustered(ThreadContext &t, NetInfo *net)
+    {
+        auto &nd = nets.at(net->udata);
+        std::vector<std::unique_ptr<ArcCluster>> clusters;
+        cluster_arcs(clusters, net,
+                     ArcBounds(0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max()), t.route_arcs,
+                     0, max_partition_depth());
+        if (clusters.size() < 2)
+            return;
+        std::vector<int> remaining;
+        // Bring the net into each region, with the arc whose sink is closest to the source
+        auto src_loc = wire_loc.at(wire_index(nd.src_wire));
+        for (auto &c : clusters) {
+            auto dist = [&](int i) {
+                auto l = wire_loc.at(wire_index(nd.arcs.at(i).sink_wire));
+                return std::abs(l.first - src_loc.first) + std::abs(l.second - src_loc.second);
+            };
+            auto first = std::min_element(c->arcs.begin(), c->arcs.end(),
+                                          [&](int a, int b) { return dist(a) < dist(b); });
+            int i = *first;
+            c->arcs.erase(first);
+            if (route_arc(t, net, i, false, true) != ARC_SUCCESS)
+                remaining.push_back(i);
+        }
+        // Collect the routing of the net so far into the region it lies in
+        pool<int> tree;
+        for (size_t i = 0; i < nd.arcs.size(); i++) {
+            if (!nd.arcs.at(i).routed)
+                continue;
+            WireId cursor = nd.arcs.at(i).sink_wire;
+            while (true) {
+                int cursor_idx = wire_index(cursor);
+                WireBinding *b = find_binding(cursor_idx, net->udata);
+                if (b == nullptr || tree.count(cursor_idx))
+                    break;
+                tree.insert(cursor_idx);
+                if (b->pip == PipId())
+                    break;
+                cursor = ctx->getPipSrcWire(b->pip);
+            }
+        }
+        for (auto &c : clusters) {
+            for (int w : tree)
+                if (thread_test_wire(c->tc, w))
+                    c->tree_wires.push_back(w);
+            std::sort(c->tree_wires.begin(), c->tree_wires.end());
+            c->tc.rng.rngseed(t.rng.rng64());
+            c->tc.queue.set_bucketed(cfg.bucket_queue, cfg.bucket_width);
+        }
+
+        TaskPool &pool = get_pool();
+        for (auto &c : clusters) {
+            ArcCluster *cp = c.get();
+            pool.add([this, cp, net]() {
+                auto start = std::chrono::high_resolution_clock::now();
+                cp->join_wire.resize(cp->arcs.size());
+                for (size_t j = 0; j < cp->arcs.size(); j++)
+                    route_arc_from_tree(*cp, net, cp->arcs.at(j), cp->join_wire.at(j));
+                auto end = std::chrono::high_resolution_clock::now();
+                cp->tc.counters.busy_time += std::chrono::duration<double>(end - start).count();
+            });
+        }
+        pool.run();
+
+        // Count the uses of the existing routing upstream of where arcs joined it
+        for (auto &c : clusters) {
+            for (size_t j = 0; j < c->arcs.size(); j++) {
+                int i = c->arcs.at(j), cursor = c->join_wire.at(j);
+                if (!nd.arcs.at(i).routed) {
+                    remaining.push_back(i);
+                    continue;
+                }
+                while (cursor != -1) {
+                    WireBinding *b = find_binding(cursor, net->udata);
+                    NPNR_ASSERT(b != nullptr);
+                    PipId pip = b->pip;
+                    bind_pip_internal(net, i, cursor, pip);
+                    cursor = (pip == PipId()) ? -1 : wire_index(ctx->getPipSrcWire(pip));
+                }
+            }
+            for (auto sink : c->tc.processed_sinks)
+                t.processed_sinks.insert(sink);
+            cluster_counters.add(c->tc.counters);
+        }
+        std::sort(remaining.begin(), remaining.end());
+        t.route_arcs = remaining;
+    }
+
     bool route_net(ThreadContext &t, NetInfo *net, bool is_mt)
     {
 
@@ -924,6 +1407,12 @@ struct Router2
             ripup_arc(net, i);
             t.route_arcs.push_back(i);
         }
+        if (!is_mt && cfg.threads > 1 && int(t.route_arcs.size()) >= cfg.mt_net_min_arcs) {
+#ifdef ARCH_XILINX
+            if (net->name != ctx->id("$PACKER_GND_NET") && net->name != ctx->id("$PACKER_VCC_NET"))
+#endif
+                route_net_clustered(t, net);
+        }
         for (auto i : t.route_arcs) {
             auto res1 = route_arc(t, net, i, is_mt, true);
             if (res1 == ARC_FATAL)
@@ -966,15 +1455,15 @@ struct Router2
         overused_wires = 0;
         total_wire_use = 0;
         failed_nets.clear();
-        for (auto &wire : flat_wires) {
-            total_wire_use += int(wire.bound_nets.size());
-            int overuse = int(wire.bound_nets.size()) - 1;
+        for (int wire = 0; wire < int(wire_ids.size()); wire++) {
+            int bound = bound_count(wire);
+            total_wire_use += bound;
+            int overuse = bound - 1;
             if (overuse > 0) {
-                wire.hist_cong_cost += overuse * hist_cong_weight;
+                hist_cong_cost[wire] += overuse * hist_cong_weight;
                 total_overuse += overuse;
                 overused_wires += 1;
-                for (auto &bound : wire.bound_nets)
-                    failed_nets.insert(bound.first);
+                for_each_binding(wire, [&](const WireBinding &b) { failed_nets.insert(b.net); });
             }
         }
         for (int n : failed_nets) {
@@ -1038,13 +1527,13 @@ struct Router2
                     break;
                 }
             }
-            auto &wd = wire_data(cursor);
-            if (!wd.bound_nets.count(net->udata)) {
+            WireBinding *b = find_binding(wire_index(cursor), net->udata);
+            if (b == nullptr) {
                 log("Failure details:\n");
                 log("    Cursor: %s\n", ctx->nameOfWire(cursor));
                 log_error("Internal error; incomplete route tree for arc %d of net %s.\n", usr_idx, ctx->nameOf(net));
             }
-            auto &p = wd.bound_nets.at(net->udata).second;
+            auto &p = b->pip;
             if (!ctx->checkPipAvail(p)) {
                 success = false;
                 break;
@@ -1067,6 +1556,194 @@ struct Router2
     }
 
     int arch_fail = 0;
+#ifdef ARCH_XILINX
+    // The xilinx Arch supports binding wires and pips of different nets from several threads at once, as long as
+    // no two nets bind the same wire. Nets are first checked in parallel against the Arch with their old routing
+    // removed, each arc that would succeed claiming the wires it needs. Where two nets claim the same wire, the
+    // net with the lowest udata wins. Arcs that still have all their wires are then bound in parallel.
+    //
+    // This isn't the same as binding the nets one at a time: a claim is kept even if the arc making it later fails
+    // to commit, and an arc joining the route of an earlier arc of its net fails with it. So arcs that failed are
+    // retried serially with bind_and_check, in udata order against everything bound so far, and only ripped up if
+    // that fails too.
+    struct ArcBindPlan
+    {
+        enum : int8_t
+        {
+            SKIP,
+            BIND,
+            FAIL,
+            INCOMPLETE
+        } state = SKIP;
+        std::vector<PipId> pips;
+        // Wire already bound to, or to be bound by an earlier arc of, the net that the route joins
+        WireId join;
+    };
+    std::vector<std::vector<ArcBindPlan>> bind_plans;
+    std::unique_ptr<std::atomic<int>[]> wire_claim;
+
+    void claim_wire(WireId w, int net)
+    {
+        auto &claim = wire_claim[wire_index(w)];
+        int curr = claim.load();
+        while (net < curr && !claim.compare_exchange_weak(curr, net))
+            ;
+    }
+
+    void plan_net_binding(NetInfo *net, std::vector<ArcBindPlan> &plans, std::vector<WireId> &claimed)
+    {
+        auto &nd = nets.at(net->udata);
+        plans.clear();
+        plans.resize(net->users.size());
+        claimed.clear();
+        WireId src = ctx->getNetinfoSourceWire(net);
+        if (src == WireId())
+            return;
+        std::unordered_set<WireId> planned;
+        auto is_ours = [&](WireId w) { return ctx->getBoundWireNet(w) == net || planned.count(w); };
+        for (size_t i = 0; i < net->users.size(); i++) {
+            auto &plan = plans.at(i);
+            WireId dst = ctx->getNetinfoSinkWire(net, net->users.at(i));
+            if (dst == WireId() || is_ours(dst))
+                continue;
+            if (dst == src) {
+                if (ctx->getBoundWireNet(src) != nullptr)
+                    continue;
+                plan.state = ArcBindPlan::BIND;
+                plan.join = src;
+            } else {
+                if (!nd.arcs.at(i).routed)
+                    continue;
+                WireId cursor = dst;
+                plan.state = ArcBindPlan::BIND;
+                while (cursor != src) {
+                    if (is_ours(cursor))
+                        break;
+                    if (!ctx->checkWireAvail(cursor)) {
+                        plan.state = ArcBindPlan::FAIL;
+                        break;
+                    }
+                    WireBinding *b = find_binding(wire_index(cursor), net->udata);
+                    if (b == nullptr) {
+                        plan.state = ArcBindPlan::INCOMPLETE;
+                        plan.join = cursor;
+                        break;
+                    }
+                    if (!ctx->checkPipAvail(b->pip)) {
+                        plan.state = ArcBindPlan::FAIL;
+                        break;
+                    }
+                    plan.pips.push_back(b->pip);
+                    cursor = ctx->getPipSrcWire(b->pip);
+                }
+                if (plan.state != ArcBindPlan::BIND)
+                    continue;
+                plan.join = cursor;
+            }
+            for (auto pip : plan.pips) {
+                WireId w = ctx->getPipDstWire(pip);
+                planned.insert(w);
+                claimed.push_back(w);
+            }
+            if (!planned.count(src) && ctx->getBoundWireNet(src) != net) {
+                planned.insert(src);
+                claimed.push_back(src);
+            }
+        }
+        for (auto w : claimed)
+            claim_wire(w, net->udata);
+    }
+
+    void commit_net_binding(NetInfo *net, std::vector<ArcBindPlan> &plans)
+    {
+        WireId src = ctx->getNetinfoSourceWire(net);
+        auto owned = [&](WireId w) { return wire_claim[wire_index(w)].load() == net->udata; };
+        for (auto &plan : plans) {
+            if (plan.state != ArcBindPlan::BIND)
+                continue;
+            // The join point must have been bound to the net beforehand, or by an arc that was itself committed
+            bool ok = (plan.join == src) || net->wires.count(plan.join);
+            if (ok && !net->wires.count(src) && !owned(src))
+                ok = false;
+            for (auto pip : plan.pips)
+                if (ok && !owned(ctx->getPipDstWire(pip)))
+                    ok = false;
+            if (!ok) {
+                plan.state = ArcBindPlan::FAIL;
+                continue;
+            }
+            if (!net->wires.count(src))
+                ctx->bindWireConcurrent(src, net, STRENGTH_WEAK);
+            for (auto pip : plan.pips)
+                ctx->bindPipConcurrent(pip, net, STRENGTH_WEAK);
+        }
+    }
+
+    bool bind_and_check_all()
+    {
+        if (!wire_claim) {
+            wire_claim.reset(new std::atomic<int>[ctx->getNumWires()]);
+            for (int i = 0; i < ctx->getNumWires(); i++)
+                wire_claim[i].store(std::numeric_limits<int>::max());
+        }
+        int num_nets = int(nets_by_udata.size());
+        bind_plans.resize(num_nets);
+        std::vector<std::vector<WireId>> claimed(num_nets);
+
+        const int chunk_size = 64;
+        auto parallel_nets = [&](std::function<void(int)> func) {
+            TaskPool &pool = get_pool();
+            for (int start = 0; start < num_nets; start += chunk_size) {
+                int end = std::min(num_nets, start + chunk_size);
+                pool.add([&func, start, end]() {
+                    for (int i = start; i < end; i++)
+                        func(i);
+                });
+            }
+            pool.run();
+        };
+
+        // Ripup wires and pips used by the nets in nextpnr's structures
+        parallel_nets([&](int i) {
+            NetInfo *net = nets_by_udata.at(i);
+            std::vector<WireId> net_wires;
+            for (auto &w : net->wires) {
+                if (w.second.strength <= STRENGTH_STRONG)
+                    net_wires.push_back(w.first);
+            }
+            for (auto w : net_wires)
+                ctx->unbindWireConcurrent(w);
+        });
+        parallel_nets([&](int i) { plan_net_binding(nets_by_udata.at(i), bind_plans.at(i), claimed.at(i)); });
+        parallel_nets([&](int i) { commit_net_binding(nets_by_udata.at(i), bind_plans.at(i)); });
+        parallel_nets([&](int i) {
+            for (auto w : claimed.at(i))
+                wire_claim[wire_index(w)].store(std::numeric_limits<int>::max());
+        });
+        ctx->refreshUi();
+
+        bool success = true;
+        for (int i = 0; i < num_nets; i++) {
+            NetInfo *net = nets_by_udata.at(i);
+            auto &plans = bind_plans.at(i);
+            for (size_t j = 0; j < plans.size(); j++) {
+                if (plans.at(j).state == ArcBindPlan::INCOMPLETE) {
+                    log("Failure details:\n");
+                    log("    Cursor: %s\n", ctx->nameOfWire(plans.at(j).join));
+                    log_error("Internal error; incomplete route tree for arc %d of net %s.\n", int(j), ctx->nameOf(net));
+                }
+                if (plans.at(j).state != ArcBindPlan::FAIL)
+                    continue;
+                // Rips the arc up if it still fails
+                if (!bind_and_check(net, j)) {
+                    ++arch_fail;
+                    success = false;
+                }
+            }
+        }
+        return success;
+    }
+#else
     bool bind_and_check_all()
     {
         bool success = true;
@@ -1094,22 +1771,22 @@ struct Router2
         }
         return success;
     }
+#endif
 
     void write_heatmap(std::ostream &out, bool congestion = false)
     {
         std::vector<std::vector<int>> hm_xy;
         int max_x = 0, max_y = 0;
-        for (auto &wd : flat_wires) {
-            int val = int(wd.bound_nets.size()) - (congestion ? 1 : 0);
-            if (wd.bound_nets.empty())
+        for (int wire = 0; wire < int(wire_ids.size()); wire++) {
+            int val = bound_count(wire) - (congestion ? 1 : 0);
+            if (bound_count(wire) == 0)
                 continue;
             // Estimate wire location by driving pip location
             PipId drv;
-            for (auto &bn : wd.bound_nets)
-                if (bn.second.second != PipId()) {
-                    drv = bn.second.second;
-                    break;
-                }
+            for_each_binding(wire, [&](const WireBinding &b) {
+                if (drv == PipId())
+                    drv = b.pip;
+            });
             if (drv == PipId())
                 continue;
             Loc l = ctx->getPipLocation(drv);
@@ -1132,156 +1809,227 @@ struct Router2
             out << std::endl;
         }
     }
-    int mid_x = 0, mid_y = 0;
 
-    void partition_nets()
+    // A node in the recursive bisection of the device used for multithreaded routing. Nets entirely
+    // inside one of the two halves are pushed down into that child; nets crossing the cut remain
+    // here and are routed once both children have finished, so that concurrently routed partitions
+    // never touch the same wires
+    struct RoutePartition
+    {
+        ArcBounds bb;
+        int depth = 0;
+        int parent = -1;
+        std::vector<int> children;
+        std::vector<NetInfo *> route_nets;
+        // Number of children still to finish routing
+        std::atomic<int> pending_children{0};
+        ThreadContext tc;
+    };
+
+    std::vector<std::unique_ptr<RoutePartition>> partitions;
+
+    int max_partition_depth()
+    {
+        // Aim for around twice as many leaf partitions as threads, so that work can be
+        // balanced between threads when partitions end up with uneven amounts of routing
+        int depth = 0;
+        while ((1 << depth) < 2 * cfg.threads)
+            ++depth;
+        return cfg.threads > 1 ? depth : 0;
+    }
+
+    void partition_nets(int idx, const std::vector<int> &net_idxs, int max_depth)
     {
-        // Create a histogram of positions in X and Y positions
-        std::map<int, int> cxs, cys;
-        for (auto &n : nets) {
-            if (n.cx != -1)
-                ++cxs[n.cx];
-            if (n.cy != -1)
-                ++cys[n.cy];
-        }
-        // 4-way split for now
-        int accum_x = 0, accum_y = 0;
-        int halfway = int(nets.size()) / 2;
-        for (auto &p : cxs) {
-            if (accum_x < halfway && (accum_x + p.second) >= halfway)
-                mid_x = p.first;
-            accum_x += p.second;
-        }
-        for (auto &p : cys) {
-            if (accum_y < halfway && (accum_y + p.second) >= halfway)
-                mid_y = p.first;
-            accum_y += p.second;
+        auto &p = *partitions.at(idx);
+        p.tc.rng.rngseed(ctx->rng64());
+        p.tc.queue.set_bucketed(cfg.bucket_queue, cfg.bucket_width);
+        p.tc.bb = p.bb;
+        if (p.depth >= max_depth || int(net_idxs.size()) < cfg.min_partition_nets) {
+            for (int n : net_idxs)
+                p.route_nets.push_back(nets_by_udata.at(n));
+            return;
         }
-        if (ctx->verbose) {
-            log_info("    x splitpoint: %d\n", mid_x);
-            log_info("    y splitpoint: %d\n", mid_y);
-        }
-        std::vector<int> bins(5, 0);
-        for (auto &n : nets) {
-            if (n.bb.x0 < mid_x && n.bb.x1 < mid_x && n.bb.y0 < mid_y && n.bb.y1 < mid_y)
-                ++bins[0]; // TL
-            else if (n.bb.x0 >= mid_x && n.bb.x1 >= mid_x && n.bb.y0 < mid_y && n.bb.y1 < mid_y)
-                ++bins[1]; // TR
-            else if (n.bb.x0 < mid_x && n.bb.x1 < mid_x && n.bb.y0 >= mid_y && n.bb.y1 >= mid_y)
-                ++bins[2]; // BL
-            else if (n.bb.x0 >= mid_x && n.bb.x1 >= mid_x && n.bb.y0 >= mid_y && n.bb.y1 >= mid_y)
-                ++bins[3]; // BR
+        // Cut across the longer dimension of the partition, at the median net centre
+        int x0 = p.bb.x0, y0 = p.bb.y0;
+        int x1 = std::min(p.bb.x1, ctx->getGridDimX()), y1 = std::min(p.bb.y1, ctx->getGridDimY());
+        bool split_x = (x1 - x0) >= (y1 - y0);
+        std::vector<int> centres;
+        for (int n : net_idxs)
+            centres.push_back(split_x ? nets.at(n).cx : nets.at(n).cy);
+        std::nth_element(centres.begin(), centres.begin() + centres.size() / 2, centres.end());
+        int cut = centres.at(centres.size() / 2);
+        if (cut < (split_x ? x0 : y0) || cut >= (split_x ? x1 : y1)) {
+            for (int n : net_idxs)
+                p.route_nets.push_back(nets_by_udata.at(n));
+            return;
+        }
+        std::vector<int> lo_nets, hi_nets;
+        for (int n : net_idxs) {
+            auto &nd = nets.at(n);
+            if ((split_x ? nd.bb.x1 : nd.bb.y1) <= cut)
+                lo_nets.push_back(n);
+            else if ((split_x ? nd.bb.x0 : nd.bb.y0) > cut)
+                hi_nets.push_back(n);
             else
-                ++bins[4]; // cross-boundary
+                p.route_nets.push_back(nets_by_udata.at(n));
+        }
+        ArcBounds lo_bb = p.bb, hi_bb = p.bb;
+        if (split_x) {
+            lo_bb.x1 = cut;
+            hi_bb.x0 = cut + 1;
+        } else {
+            lo_bb.y1 = cut;
+            hi_bb.y0 = cut + 1;
         }
-        if (ctx->verbose)
-            for (int i = 0; i < 5; i++)
-                log_info("        bin %d N=%d\n", i, bins[i]);
+        for (auto &child : {std::make_pair(lo_bb, &lo_nets), std::make_pair(hi_bb, &hi_nets)}) {
+            int child_idx = int(partitions.size());
+            partitions.emplace_back(new RoutePartition);
+            auto &c = *partitions.back();
+            c.bb = child.first;
+            c.depth = p.depth + 1;
+            c.parent = idx;
+            p.children.push_back(child_idx);
+            partition_nets(child_idx, *child.second, max_depth);
+        }
+        p.pending_children = int(p.children.size());
     }
 
-    void router_thread(ThreadContext &t)
+    void router_thread(ThreadContext &t, const std::vector<NetInfo *> &route_nets)
     {
-        for (auto n : t.route_nets) {
+        for (auto n : route_nets) {
             bool result = route_net(t, n, true);
             if (!result)
                 t.failed_nets.push_back(n);
         }
     }
 
+    void route_partition(TaskPool &pool, int idx)
+    {
+        auto &p = *partitions.at(idx);
+        auto start = std::chrono::high_resolution_clock::now();
+        router_thread(p.tc, p.route_nets);
+        auto end = std::chrono::high_resolution_clock::now();
+        p.tc.counters.busy_time += std::chrono::duration<double>(end - start).count();
+        // Once all the children of a partition are done, its cut-crossing nets can be routed. The
+        // root partition is left for the singlethreaded pass, where bounding boxes can be broken out of
+        int parent = p.parent;
+        if (parent > 0 && --partitions.at(parent)->pending_children == 0)
+            pool.add([this, &pool, parent]() { route_partition(pool, parent); });
+    }
+
+    // Statistics of the current iteration
+    RouteCounters iter_counters;
+    double iter_mt_time = 0, iter_mt_busy = 0;
+
     void do_route()
     {
+        iter_counters = RouteCounters();
+        cluster_counters = RouteCounters();
+        iter_mt_time = 0;
+        iter_mt_busy = 0;
         // Don't multithread if fewer than 200 nets (heuristic)
-        if (route_queue.size() < 200) {
+        if (route_queue.size() < 200 || cfg.threads <= 1) {
             ThreadContext st;
             st.rng.rngseed(ctx->rng64());
+            st.queue.set_bucketed(cfg.bucket_queue, cfg.bucket_width);
             st.bb = ArcBounds(0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+            auto start = std::chrono::high_resolution_clock::now();
             for (size_t j = 0; j < route_queue.size(); j++) {
                 route_net(st, nets_by_udata[route_queue[j]], false);
             }
+            auto end = std::chrono::high_resolution_clock::now();
+            st.counters.busy_time = std::chrono::duration<double>(end - start).count();
+            iter_counters.add(st.counters);
             return;
         }
-        const int Nq = 4, Nv = 2, Nh = 2;
-        const int N = Nq + Nv + Nh;
-        std::vector<ThreadContext> tcs(N + 1);
-        for (auto &th : tcs) {
-            th.rng.rngseed(ctx->rng64());
+        partitions.clear();
+        partitions.emplace_back(new RoutePartition);
+        partitions.back()->bb = ArcBounds(0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+        partition_nets(0, route_queue, max_partition_depth());
+        auto &root = *partitions.at(0);
+        if (ctx->verbose) {
+            int leaves = 0;
+            for (auto &p : partitions)
+                if (p->children.empty())
+                    ++leaves;
+            log_info("%d/%d nets not multi-threadable (%d partitions, %d leaves)\n", int(root.route_nets.size()),
+                     int(route_queue.size()), int(partitions.size()), leaves);
         }
-        int le_x = mid_x;
-        int rs_x = mid_x;
-        int le_y = mid_y;
-        int rs_y = mid_y;
-        // Set up thread bounding boxes
-        tcs.at(0).bb = ArcBounds(0, 0, mid_x, mid_y);
-        tcs.at(1).bb = ArcBounds(mid_x + 1, 0, std::numeric_limits<int>::max(), le_y);
-        tcs.at(2).bb = ArcBounds(0, mid_y + 1, mid_x, std::numeric_limits<int>::max());
-        tcs.at(3).bb =
-                ArcBounds(mid_x + 1, mid_y + 1, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-
-        tcs.at(4).bb = ArcBounds(0, 0, std::numeric_limits<int>::max(), mid_y);
-        tcs.at(5).bb = ArcBounds(0, mid_y + 1, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-
-        tcs.at(6).bb = ArcBounds(0, 0, mid_x, std::numeric_limits<int>::max());
-        tcs.at(7).bb = ArcBounds(mid_x + 1, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-
-        tcs.at(8).bb = ArcBounds(0, 0, std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-
-        for (auto n : route_queue) {
-            auto &nd = nets.at(n);
-            auto ni = nets_by_udata.at(n);
-            int bin = N;
-            // Quadrants
-            if (nd.bb.x0 < le_x && nd.bb.x1 < le_x && nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = 0;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x && nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = 1;
-            else if (nd.bb.x0 < le_x && nd.bb.x1 < le_x && nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = 2;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x && nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = 3;
-            // Vertical split
-            else if (nd.bb.y0 < le_y && nd.bb.y1 < le_y)
-                bin = Nq + 0;
-            else if (nd.bb.y0 >= rs_y && nd.bb.y1 >= rs_y)
-                bin = Nq + 1;
-            // Horizontal split
-            else if (nd.bb.x0 < le_x && nd.bb.x1 < le_x)
-                bin = Nq + Nv + 0;
-            else if (nd.bb.x0 >= rs_x && nd.bb.x1 >= rs_x)
-                bin = Nq + Nv + 1;
-            tcs.at(bin).route_nets.push_back(ni);
-        }
-        if (ctx->verbose)
-            log_info("%d/%d nets not multi-threadable\n", int(tcs.at(N).route_nets.size()), int(route_queue.size()));
-        // Multithreaded part of routing - quadrants
-        std::vector<std::thread> threads;
-        for (int i = 0; i < Nq; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i)); });
-        }
-        for (auto &t : threads)
-            t.join();
-        threads.clear();
-        // Vertical splits
-        for (int i = Nq; i < Nq + Nv; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i)); });
-        }
-        for (auto &t : threads)
-            t.join();
-        threads.clear();
-        // Horizontal splits
-        for (int i = Nq + Nv; i < Nq + Nv + Nh; i++) {
-            threads.emplace_back([this, &tcs, i]() { router_thread(tcs.at(i)); });
-        }
-        for (auto &t : threads)
-            t.join();
-        threads.clear();
-        // Singlethreaded part of routing - nets that cross partitions
+        // Multithreaded part of routing - start with the leaf partitions, parents are queued
+        // by their last child to finish
+        TaskPool &pool = get_pool();
+        for (int i = 1; i < int(partitions.size()); i++) {
+            if (partitions.at(i)->children.empty())
+                pool.add([this, &pool, i]() { route_partition(pool, i); });
+        }
+        auto mt_start = std::chrono::high_resolution_clock::now();
+        pool.run();
+        auto mt_end = std::chrono::high_resolution_clock::now();
+        iter_mt_time = std::chrono::duration<double>(mt_end - mt_start).count();
+        for (int i = 1; i < int(partitions.size()); i++)
+            iter_mt_busy += partitions.at(i)->tc.counters.busy_time;
+        // Singlethreaded part of routing - nets that cross the top-level cut
         // or don't fit within bounding box
-        for (auto st_net : tcs.at(N).route_nets)
-            route_net(tcs.at(N), st_net, false);
+        for (auto st_net : root.route_nets)
+            route_net(root.tc, st_net, false);
         // Failed nets
-        for (int i = 0; i < N; i++)
-            for (auto fail : tcs.at(i).failed_nets)
-                route_net(tcs.at(N), fail, false);
+        for (int i = 1; i < int(partitions.size()); i++)
+            for (auto fail : partitions.at(i)->tc.failed_nets)
+                route_net(root.tc, fail, false);
+        auto st_end = std::chrono::high_resolution_clock::now();
+        root.tc.counters.busy_time = std::chrono::duration<double>(st_end - mt_end).count();
+        for (auto &p : partitions)
+            iter_counters.add(p->tc.counters);
+    }
+
+    struct IterationPerf
+    {
+        int iter, nets_routed;
+        int wires, overused, overuse;
+        // -1 if binding wasn't attempted, as wires were still overused
+        int arch_fail;
+        // Seconds spent in timing analysis, routing, the multithreaded part of routing, and binding
+        double sta_time, route_time, mt_route_time, bind_time, total_time;
+        // Fraction of the multithreaded part of routing that the threads spent routing nets
+        double mt_utilisation;
+        RouteCounters counters, cluster_counters;
+    };
+    std::vector<IterationPerf> perf_iters;
+
+    void write_perf_report(const std::string &filename, double total_time)
+    {
+        std::ofstream out(filename);
+        if (!out)
+            log_error("Failed to open route performance report '%s' for writing.\n", filename.c_str());
+        auto write_counters = [&](const RouteCounters &c) {
+            out << "{\"arcs\": " << c.arcs << ", \"wires_explored\": " << c.explored
+                << ", \"queue_pushes\": " << c.pushes << ", \"queue_pops\": " << c.pops
+                << ", \"backwards_hits\": " << c.bwd_success << ", \"backwards_iters\": " << c.bwd_iters
+                << ", \"bb_failures\": " << c.bb_failures << ", \"busy_time\": " << c.busy_time << "}";
+        };
+        out << "{\n";
+        out << "  \"router\": \"router2\",\n";
+        out << "  \"threads\": " << cfg.threads << ",\n";
+        out << "  \"nets\": " << nets_by_udata.size() << ",\n";
+        out << "  \"wires\": " << wire_ids.size() << ",\n";
+        out << "  \"total_time\": " << total_time << ",\n";
+        out << "  \"iterations\": [";
+        for (size_t i = 0; i < perf_iters.size(); i++) {
+            auto &it = perf_iters.at(i);
+            out << (i > 0 ? "," : "") << "\n    {";
+            out << "\"iter\": " << it.iter << ", \"nets_routed\": " << it.nets_routed << ", \"wires\": " << it.wires
+                << ", \"overused\": " << it.overused << ", \"overuse\": " << it.overuse
+                << ", \"arch_fail\": " << it.arch_fail << ",\n     ";
+            out << "\"sta_time\": " << it.sta_time << ", \"route_time\": " << it.route_time
+                << ", \"mt_route_time\": " << it.mt_route_time << ", \"mt_utilisation\": " << it.mt_utilisation
+                << ", \"bind_time\": " << it.bind_time << ", \"total_time\": " << it.total_time << ",\n     ";
+            out << "\"search\": ";
+            write_counters(it.counters);
+            out << ",\n     \"cluster_search\": ";
+            write_counters(it.cluster_counters);
+            out << "}";
+        }
+        out << "\n  ]\n}\n";
     }
 
     //#define ROUTER2_STATISTICS
@@ -1289,11 +2037,11 @@ struct Router2
     void dump_statistics()
     {
 #ifdef ROUTER2_STATISTICS
-        int total_wires = int(flat_wires.size());
+        int total_wires = int(wire_ids.size());
         int have_hist_cong = 0;
         int have_any_bound = 0, have_1_bound = 0, have_2_bound = 0, have_gte3_bound = 0;
-        for (auto &wire : flat_wires) {
-            int bound = wire.bound_nets.size();
+        for (int wire = 0; wire < total_wires; wire++) {
+            int bound = bound_count(wire);
             if (bound != 0)
                 ++have_any_bound;
             if (bound == 1)
@@ -1302,7 +2050,7 @@ struct Router2
                 ++have_2_bound;
             else if (bound >= 3)
                 ++have_gte3_bound;
-            if (wire.hist_cong_cost > 1.0)
+            if (hist_cong_cost[wire] > 1.0)
                 ++have_hist_cong;
         }
         log_info("Out of %d wires:\n", total_wires);
@@ -1323,24 +2071,32 @@ struct Router2
         setup_nets();
         setup_wires();
         find_all_reserved_wires();
-        partition_nets();
         curr_cong_weight = cfg.init_curr_cong_weight;
         hist_cong_weight = cfg.hist_cong_weight;
         ThreadContext st;
         int iter = 1;
 
-        for (size_t i = 0; i < nets_by_udata.size(); i++)
-            route_queue.push_back(i);
+        if (cfg.incremental) {
+            seed_existing_routing();
+        } else {
+            for (size_t i = 0; i < nets_by_udata.size(); i++)
+                route_queue.push_back(i);
+        }
 
         timing_driven = ctx->setting<bool>("timing_driven");
+        routed_since_bind.assign(nets_by_udata.size(), 0);
         log_info("Running main router loop...\n");
         do {
+            auto iter_start = std::chrono::high_resolution_clock::now();
+            IterationPerf perf;
+            perf.iter = iter;
+            perf.nets_routed = int(route_queue.size());
             ctx->sorted_shuffle(route_queue);
 
             if (timing_driven && (int(route_queue.size()) > (int(nets_by_udata.size()) / 50))) {
                 // Heuristic: reduce runtime by skipping STA in the case of a "long tail" of a few
                 // congested nodes
-                get_criticalities(ctx, &net_crit);
+                update_criticalities();
                 for (auto n : route_queue) {
                     IdString name = nets_by_udata.at(n)->name;
                     auto fnd = net_crit.find(name);
@@ -1357,6 +2113,7 @@ struct Router2
                 std::stable_sort(route_queue.begin(), route_queue.end(),
                                  [&](int na, int nb) { return nets.at(na).max_crit > nets.at(nb).max_crit; });
             }
+            auto route_start = std::chrono::high_resolution_clock::now();
 
 #if 0
             for (size_t j = 0; j < route_queue.size(); j++) {
@@ -1366,6 +2123,9 @@ struct Router2
             }
 #endif
             do_route();
+            auto route_end = std::chrono::high_resolution_clock::now();
+            for (auto n : route_queue)
+                routed_since_bind.at(n) = 1;
             route_queue.clear();
             update_congestion();
 #if 0
@@ -1376,14 +2136,39 @@ struct Router2
 #endif
             dump_statistics();
 
+            auto bind_start = std::chrono::high_resolution_clock::now();
             if (overused_wires == 0) {
                 // Try and actually bind nextpnr Arch API wires
                 bind_and_check_all();
+                for (size_t i = 0; i < routed_since_bind.size(); i++)
+                    if (routed_since_bind.at(i)) {
+                        timing_dirty.push_back(nets_by_udata.at(i));
+                        routed_since_bind.at(i) = 0;
+                    }
             }
+            auto bind_end = std::chrono::high_resolution_clock::now();
             for (auto cn : failed_nets)
                 route_queue.push_back(cn);
             log_info("    iter=%d wires=%d overused=%d overuse=%d archfail=%s\n", iter, total_wire_use, overused_wires,
                      total_overuse, overused_wires > 0 ? "NA" : std::to_string(arch_fail).c_str());
+            auto iter_end = std::chrono::high_resolution_clock::now();
+            if (cfg.perf_profile)
+                log_info("        iteration time %.02fs\n", std::chrono::duration<float>(iter_end - iter_start).count());
+            if (!cfg.perf_report.empty()) {
+                perf.wires = total_wire_use;
+                perf.overused = overused_wires;
+                perf.overuse = total_overuse;
+                perf.arch_fail = overused_wires > 0 ? -1 : arch_fail;
+                perf.sta_time = std::chrono::duration<double>(route_start - iter_start).count();
+                perf.route_time = std::chrono::duration<double>(route_end - route_start).count();
+                perf.mt_route_time = iter_mt_time;
+                perf.mt_utilisation = iter_mt_time > 0 ? iter_mt_busy / (iter_mt_time * cfg.threads) : 0;
+                perf.bind_time = std::chrono::duration<double>(bind_end - bind_start).count();
+                perf.total_time = std::chrono::duration<double>(iter_end - iter_start).count();
+                perf.counters = iter_counters;
+                perf.cluster_counters = cluster_counters;
+                perf_iters.push_back(perf);
+            }
             ++iter;
             if (curr_cong_weight < 1e9)
                 curr_cong_weight += cfg.curr_cong_mult;
@@ -1404,9 +2189,26 @@ struct Router2
         auto rend = std::chrono::high_resolution_clock::now();
         log_info("Router2 time %.02fs\n", std::chrono::duration<float>(rend - rstart).count());
 
-        log_info("Running router1 to check that route is legal...\n");
-
-        router1(ctx, Router1Cfg(ctx));
+        log_info("Checking that route is legal...\n");
+        std::vector<NetInfo *> check_failed;
+        if (!check_routing(ctx, check_failed, cfg.threads)) {
+            // Fall back to router1 for just the nets that failed; it leaves nets that are fully routed alone
+            log_info("Running router1 to fix %d nets that failed the check...\n", int(check_failed.size()));
+            std::vector<WireId> net_wires;
+            for (auto net : check_failed) {
+                net_wires.clear();
+                for (auto &w : net->wires)
+                    if (w.second.strength <= STRENGTH_STRONG)
+                        net_wires.push_back(w.first);
+                for (auto w : net_wires)
+                    ctx->unbindWire(w);
+            }
+            router1(ctx, Router1Cfg(ctx));
+        }
+        if (!cfg.perf_report.empty()) {
+            auto check_end = std::chrono::high_resolution_clock::now();
+            write_perf_report(cfg.perf_report, std::chrono::duration<double>(check_end - rstart).count());
+        }
     }
 };
 } // namespace
@@ -1431,6 +2233,13 @@ Router2Cfg::Router2Cfg(Context *ctx)
     curr_cong_mult = ctx->setting<float>("router2/currCongWeightMult", 2.0f);
     estimate_weight = ctx->setting<float>("router2/estimateWeight", 1.75f);
     perf_profile = ctx->setting<float>("router2/perfProfile", false);
+    min_partition_nets = ctx->setting<int>("router2/minPartitionNets", 200);
+    mt_net_min_arcs = ctx->setting<int>("router2/mtNetMinArcs", 100);
+    bucket_queue = ctx->setting<bool>("router2/bucketQueue", false);
+    perf_report = str_or_default(ctx->settings, ctx->id("router2/perfReport"), "");
+    bucket_width = ctx->setting<float>("router2/bucketWidth", 0.02f);
+    incremental = ctx->setting<bool>("router2/incremental", false);
+    threads = get_thread_count(ctx);
 }
 
 NEXTPNR_NAMESPACE_END
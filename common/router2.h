@@ -49,6 +49,23 @@ struct Router2Cfg
 
     // Print additional performance profiling information
     bool perf_profile = false;
+    // If not empty, write per-iteration performance counters to this file, as JSON
+    std::string perf_report;
+
+    // Number of threads to route with
+    int threads;
+    // Partitions of the device with fewer nets than this are not split further
+    int min_partition_nets;
+    // Nets left to the singlethreaded pass with at least this many arcs to route have their arcs routed in
+    // parallel, clustered by sink location
+    int mt_net_min_arcs;
+
+    // Use a bucket queue instead of a binary heap for A*, with buckets of this width in cost
+    bool bucket_queue;
+    float bucket_width;
+
+    // Keep existing routing that is still legal, and only reroute nets that changed
+    bool incremental;
 };
 
 void router2(Context *ctx, const Router2Cfg &cfg);
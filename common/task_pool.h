@@ -0,0 +1,231 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// A small work-stealing task pool. Each worker owns a deque of tasks; it pops
+// from the back of its own deque (so tasks spawned by a task tend to run on the
+// same thread, with warm caches) and steals from the front of other workers'
+// deques when it runs out of work. Tasks may add further tasks while running;
+// run() returns once every task, including those spawned later, has finished.
+// If a task throws, for example through log_error or NPNR_ASSERT, the remaining
+// tasks still run, and then run() rethrows the first exception on the calling
+// thread, where the usual handlers can catch it.
+//
+// The worker threads are started once, by the constructor, and sleep between
+// calls to run(), which makes the thread that calls run() worker 0. Keep one
+// pool per placer, router or timing graph and reuse it, rather than creating
+// one for every batch of tasks. A pool is run by one thread at a time, and not
+// from inside one of its own tasks.
+struct TaskPool
+{
+    explicit TaskPool(int threads) : queues(std::max(threads, 1))
+    {
+        for (int i = 1; i < num_threads(); i++)
+            helpers.emplace_back([this, i]() { helper(i); });
+    }
+
+    ~TaskPool()
+    {
+        {
+            std::lock_guard<std::mutex> lk(wake_mutex);
+            stopping = true;
+        }
+        start_cv.notify_all();
+        for (auto &h : helpers)
+            h.join();
+    }
+
+    int num_threads() const { return int(queues.size()); }
+
+    // Add a task. When called from inside a running task, it is queued on the
+    // calling worker's own deque; otherwise tasks are distributed round-robin
+    void add(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lk(wake_mutex);
+            ++pending;
+            ++queued;
+        }
+        int q = (current_pool() == this) ? current_worker() : int(next_queue++ % unsigned(num_threads()));
+        {
+            std::lock_guard<std::mutex> lk(queues.at(q).mutex);
+            queues.at(q).tasks.push_back(std::move(task));
+        }
+        wake_cv.notify_one();
+    }
+
+    // Run all tasks to completion on num_threads() threads, including the
+    // calling thread. With a single thread, everything runs on the calling thread.
+    void run()
+    {
+        NPNR_ASSERT(current_pool() != this);
+        {
+            std::lock_guard<std::mutex> lk(wake_mutex);
+            ++generation;
+            active_helpers = num_threads() - 1;
+        }
+        start_cv.notify_all();
+        worker(0);
+        {
+            std::unique_lock<std::mutex> lk(wake_mutex);
+            done_cv.wait(lk, [&]() { return active_helpers == 0; });
+        }
+        if (error) {
+            std::exception_ptr e = error;
+            error = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+  private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<WorkerQueue> queues;
+    std::atomic<unsigned> next_queue{0};
+    std::vector<std::thread> helpers;
+
+    std::mutex wake_mutex;
+    // Wakes workers waiting for tasks; starts helpers for a run; signals the end of a run to run()
+    std::condition_variable wake_cv, start_cv, done_cv;
+    // Incremented by each run(); helpers that have not finished the current run; set by the destructor
+    uint64_t generation = 0;
+    int active_helpers = 0;
+    bool stopping = false;
+    // Tasks added but not yet finished; tasks added but not yet started
+    int pending = 0, queued = 0;
+    // The first exception thrown by a task, protected by wake_mutex
+    std::exception_ptr error;
+
+    static const TaskPool *&current_pool()
+    {
+        static thread_local const TaskPool *pool = nullptr;
+        return pool;
+    }
+
+    static int &current_worker()
+    {
+        static thread_local int worker = -1;
+        return worker;
+    }
+
+    bool try_get(int idx, std::function<void()> &task)
+    {
+        int n = num_threads();
+        for (int i = 0; i < n; i++) {
+            auto &q = queues.at((idx + i) % n);
+            std::lock_guard<std::mutex> lk(q.mutex);
+            if (q.tasks.empty())
+                continue;
+            if (i == 0) {
+                // Own queue - LIFO
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+            } else {
+                // Steal - FIFO, taking the oldest (and usually largest) task
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Main loop of the threads other than the caller of run(), which sleep until the next run
+    void helper(int idx)
+    {
+        uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lk(wake_mutex);
+                start_cv.wait(lk, [&]() { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+            }
+            worker(idx);
+            bool done;
+            {
+                std::lock_guard<std::mutex> lk(wake_mutex);
+                done = (--active_helpers == 0);
+            }
+            if (done)
+                done_cv.notify_all();
+        }
+    }
+
+    void worker(int idx)
+    {
+        const TaskPool *prev_pool = current_pool();
+        int prev_worker = current_worker();
+        current_pool() = this;
+        current_worker() = idx;
+        while (true) {
+            std::function<void()> task;
+            if (try_get(idx, task)) {
+                {
+                    std::lock_guard<std::mutex> lk(wake_mutex);
+                    --queued;
+                }
+                try {
+                    task();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lk(wake_mutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+                bool done;
+                {
+                    std::lock_guard<std::mutex> lk(wake_mutex);
+                    done = (--pending == 0);
+                }
+                if (done)
+                    wake_cv.notify_all();
+                continue;
+            }
+            std::unique_lock<std::mutex> lk(wake_mutex);
+            wake_cv.wait(lk, [&]() { return pending == 0 || queued > 0; });
+            if (pending == 0)
+                break;
+        }
+        current_pool() = prev_pool;
+        current_worker() = prev_worker;
+    }
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
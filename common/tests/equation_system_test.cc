@@ -0,0 +1,172 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifdef WITH_HEAP
+
+#include <vector>
+#include "equation_system.h"
+#include "gtest/gtest.h"
+#include "nextpnr.h"
+
+USING_NEXTPNR_NAMESPACE
+
+namespace {
+const int N = 200;
+
+struct Connection
+{
+    int a, b;
+    double weight;
+};
+
+// Connections between movable cells and to fixed anchors, in the shape of the placer's net model
+struct Problem
+{
+    std::vector<Connection> conns;
+    std::vector<std::pair<int, double>> anchors;
+
+    Problem(uint64_t seed, int extra_conns)
+    {
+        DeterministicRNG rng;
+        rng.rngseed(seed);
+        for (int i = 0; i + 1 < N; i++)
+            conns.push_back(Connection{i, i + 1, 1.0 + rng.rng(100) / 10.0});
+        for (int i = 0; i < extra_conns; i++) {
+            int a = rng.rng(N), b = rng.rng(N);
+            if (a != b)
+                conns.push_back(Connection{a, b, 1.0 + rng.rng(100) / 10.0});
+        }
+        for (int i = 0; i < N; i += 7)
+            anchors.emplace_back(i, double(rng.rng(1000)));
+    }
+
+    // Add the system, with each connection contributing its own (duplicate) diagonal entries as the placer does
+    void build(EquationSystem<double> &es, double scale) const
+    {
+        es.reset();
+        for (auto &c : conns) {
+            double w = c.weight * scale;
+            es.add_coeff(c.a, c.a, w);
+            es.add_coeff(c.b, c.b, w);
+            es.add_coeff(c.a, c.b, -w);
+            es.add_coeff(c.b, c.a, -w);
+        }
+        for (auto &an : anchors) {
+            es.add_coeff(an.first, an.first, scale);
+            es.add_rhs(an.first, scale * an.second);
+        }
+    }
+};
+
+std::vector<double> solve_fresh(const Problem &p, double scale, PlacerHeapCfg::SolverType solver)
+{
+    EquationSystem<double> es(N, N);
+    es.set_solver(solver);
+    p.build(es, scale);
+    std::vector<double> x(N, 0.0);
+    es.solve(x, 1e-12);
+    EXPECT_EQ(es.rebuild_count(), 1);
+    return x;
+}
+
+void expect_same_solution(const std::vector<double> &x, const std::vector<double> &expected)
+{
+    ASSERT_EQ(x.size(), expected.size());
+    for (size_t i = 0; i < x.size(); i++)
+        EXPECT_NEAR(x.at(i), expected.at(i), 1e-6);
+}
+
+void check_value_update(PlacerHeapCfg::SolverType solver)
+{
+    Problem p(1, 100);
+    EquationSystem<double> es(N, N);
+    es.set_solver(solver);
+    p.build(es, 1.0);
+    std::vector<double> x(N, 0.0);
+    es.solve(x, 1e-12);
+    expect_same_solution(x, solve_fresh(p, 1.0, solver));
+    // Same pattern, different values: only the values of the existing matrix are rewritten
+    for (double scale : {2.5, 0.3, 7.0}) {
+        p.build(es, scale);
+        std::fill(x.begin(), x.end(), 0.0);
+        es.solve(x, 1e-12);
+        EXPECT_EQ(es.rebuild_count(), 1);
+        expect_same_solution(x, solve_fresh(p, scale, solver));
+    }
+}
+} // namespace
+
+TEST(EquationSystemTest, valueUpdateMatchesFreshBuild) { check_value_update(PlacerHeapCfg::SOLVER_CG); }
+
+TEST(EquationSystemTest, valueUpdateMatchesFreshBuildIccg) { check_value_update(PlacerHeapCfg::SOLVER_ICCG); }
+
+TEST(EquationSystemTest, subsetOfPatternKeepsMatrix)
+{
+    Problem full(2, 100);
+    EquationSystem<double> es(N, N);
+    full.build(es, 1.0);
+    std::vector<double> x(N, 0.0);
+    es.solve(x, 1e-12);
+    // Drop some connections: their entries remain in the pattern as explicit zeros
+    Problem subset = full;
+    subset.conns.resize(subset.conns.size() - 50);
+    subset.build(es, 1.0);
+    std::fill(x.begin(), x.end(), 0.0);
+    es.solve(x, 1e-12);
+    EXPECT_EQ(es.rebuild_count(), 1);
+    expect_same_solution(x, solve_fresh(subset, 1.0, PlacerHeapCfg::SOLVER_CG));
+}
+
+TEST(EquationSystemTest, coefficientOutsidePatternRebuilds)
+{
+    Problem p(3, 20);
+    EquationSystem<double> es(N, N);
+    p.build(es, 1.0);
+    std::vector<double> x(N, 0.0);
+    es.solve(x, 1e-12);
+    EXPECT_EQ(es.rebuild_count(), 1);
+    // A connection between the two ends of the chain is not in the pattern
+    Problem extended = p;
+    extended.conns.push_back(Connection{0, N - 1, 3.0});
+    extended.build(es, 1.0);
+    std::fill(x.begin(), x.end(), 0.0);
+    es.solve(x, 1e-12);
+    EXPECT_EQ(es.rebuild_count(), 2);
+    expect_same_solution(x, solve_fresh(extended, 1.0, PlacerHeapCfg::SOLVER_CG));
+    // The rebuilt pattern is kept for the next solve
+    extended.build(es, 2.0);
+    es.solve(x, 1e-12);
+    EXPECT_EQ(es.rebuild_count(), 2);
+}
+
+TEST(EquationSystemTest, resizeRebuilds)
+{
+    Problem p(4, 20);
+    EquationSystem<double> es(N, N);
+    p.build(es, 1.0);
+    std::vector<double> x(N, 0.0);
+    es.solve(x, 1e-12);
+    es.resize(N + 1, N + 1);
+    es.resize(N, N);
+    p.build(es, 1.0);
+    es.solve(x, 1e-12);
+    EXPECT_EQ(es.rebuild_count(), 2);
+}
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nextpnr.h"
+#include "route_queue.h"
+
+USING_NEXTPNR_NAMESPACE
+
+namespace {
+struct Item
+{
+    float key;
+    int id;
+
+    struct Greater
+    {
+        bool operator()(const Item &lhs, const Item &rhs) const
+        {
+            return lhs.key == rhs.key ? lhs.id > rhs.id : lhs.key > rhs.key;
+        }
+    };
+};
+
+typedef RouteQueue<Item, Item::Greater> Queue;
+
+std::vector<Item> random_items(int count, int max_key, uint64_t seed)
+{
+    DeterministicRNG rng;
+    rng.rngseed(seed);
+    std::vector<Item> items;
+    for (int i = 0; i < count; i++)
+        items.push_back(Item{float(rng.rng(max_key)), i});
+    return items;
+}
+
+std::vector<Item> pop_all(Queue &queue)
+{
+    std::vector<Item> popped;
+    while (!queue.empty()) {
+        popped.push_back(queue.top());
+        queue.pop();
+    }
+    return popped;
+}
+
+// Replay a synthetic A* search: each pop pushes a few successors whose keys add a random delay to the popped key,
+// as expanding a wire adds the delay of a pip and the wire it drives. Returns pops per second.
+double replay_search(Queue &queue, int num_pops, uint64_t seed)
+{
+    DeterministicRNG rng;
+    rng.rngseed(seed);
+    queue.clear();
+    int next_id = 0;
+    queue.push(Item{0, next_id++}, 0);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < num_pops && !queue.empty(); i++) {
+        Item curr = queue.top();
+        queue.pop();
+        for (int j = 0; j < 3; j++) {
+            float key = curr.key + float(20 + rng.rng(400));
+            queue.push(Item{key, next_id++}, key);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return num_pops / std::chrono::duration<double>(end - start).count();
+}
+} // namespace
+
+TEST(RouteQueueTest, heapPopsInExactOrder)
+{
+    Queue queue(false, 10.0f);
+    auto items = random_items(10000, 100000, 1);
+    for (auto &item : items)
+        queue.push(item, item.key);
+    auto popped = pop_all(queue);
+    std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) { return Item::Greater()(b, a); });
+    ASSERT_EQ(popped.size(), items.size());
+    for (size_t i = 0; i < items.size(); i++)
+        EXPECT_EQ(popped.at(i).id, items.at(i).id);
+}
+
+TEST(RouteQueueTest, bucketsPopInBucketOrder)
+{
+    const float width = 10.0f;
+    Queue queue(true, width);
+    auto items = random_items(10000, 100000, 2);
+    for (auto &item : items)
+        queue.push(item, item.key);
+    auto popped = pop_all(queue);
+    ASSERT_EQ(popped.size(), items.size());
+    for (size_t i = 1; i < popped.size(); i++)
+        EXPECT_LE(std::floor(popped.at(i - 1).key / width), std::floor(popped.at(i).key / width));
+}
+
+TEST(RouteQueueTest, bucketIsLifo)
+{
+    Queue queue(true, 10.0f);
+    // All in the bucket for [10, 20), pushed in increasing key order
+    for (int i = 0; i < 5; i++)
+        queue.push(Item{10.0f + i, i}, 10.0f + i);
+    queue.push(Item{25.0f, 5}, 25.0f);
+    auto popped = pop_all(queue);
+    ASSERT_EQ(popped.size(), 6U);
+    for (int i = 0; i < 5; i++)
+        EXPECT_EQ(popped.at(i).id, 4 - i);
+    EXPECT_EQ(popped.at(5).id, 5);
+}
+
+TEST(RouteQueueTest, keysBeyondLastBucketOverflowToHeap)
+{
+    // 65536 buckets of width 1, so keys from 65536 on go to the heap
+    Queue queue(true, 1.0f);
+    std::vector<float> keys{70000.5f, 3.0f, 100000.0f, 65536.0f, 1.0f, 80000.25f, 65535.0f};
+    for (int i = 0; i < int(keys.size()); i++)
+        queue.push(Item{keys.at(i), i}, keys.at(i));
+    auto popped = pop_all(queue);
+    std::vector<float> expected{1.0f, 3.0f, 65535.0f, 65536.0f, 70000.5f, 80000.25f, 100000.0f};
+    ASSERT_EQ(popped.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++)
+        EXPECT_EQ(popped.at(i).key, expected.at(i));
+}
+
+TEST(RouteQueueTest, clearKeepsQueueUsable)
+{
+    Queue queue(true, 10.0f);
+    for (auto &item : random_items(1000, 5000, 3))
+        queue.push(item, item.key);
+    queue.pop();
+    queue.clear();
+    EXPECT_TRUE(queue.empty());
+    queue.push(Item{42.0f, 0}, 42.0f);
+    queue.push(Item{7.0f, 1}, 7.0f);
+    EXPECT_EQ(queue.size(), 2U);
+    EXPECT_EQ(queue.top().id, 1);
+}
+
+TEST(RouteQueueTest, replaySearch)
+{
+    const int num_pops = 1000000;
+    Queue heap(false, 10.0f), buckets(true, 10.0f);
+    // Warm up allocations, as a router reusing the queue for every arc would
+    replay_search(heap, num_pops, 4);
+    replay_search(buckets, num_pops, 4);
+    double heap_rate = replay_search(heap, num_pops, 5);
+    double bucket_rate = replay_search(buckets, num_pops, 5);
+    printf("RouteQueue replay of %d pops: heap %.2fM pops/s, buckets %.2fM pops/s (%.2fx)\n", num_pops,
+           heap_rate / 1e6, bucket_rate / 1e6, bucket_rate / heap_rate);
+    EXPECT_GT(heap_rate, 0);
+    EXPECT_GT(bucket_rate, 0);
+}
@@ -0,0 +1,98 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <atomic>
+#include <stdexcept>
+#include "gtest/gtest.h"
+#include "task_pool.h"
+
+USING_NEXTPNR_NAMESPACE
+
+namespace {
+// Add a task that splits [begin, end) in halves until they are small, as the spreader and router partitions do
+void add_split(TaskPool &pool, std::atomic<int> &sum, int begin, int end)
+{
+    pool.add([&pool, &sum, begin, end]() {
+        if (end - begin <= 4) {
+            for (int i = begin; i < end; i++)
+                sum += i;
+            return;
+        }
+        int mid = (begin + end) / 2;
+        add_split(pool, sum, begin, mid);
+        add_split(pool, sum, mid, end);
+    });
+}
+} // namespace
+
+TEST(TaskPoolTest, reusedAcrossRuns)
+{
+    for (int threads : {1, 2, 4}) {
+        TaskPool pool(threads);
+        for (int run = 0; run < 200; run++) {
+            std::atomic<int> sum{0};
+            for (int i = 0; i < 10; i++)
+                pool.add([&sum, i]() { sum += i; });
+            pool.run();
+            EXPECT_EQ(sum.load(), 45);
+        }
+    }
+}
+
+TEST(TaskPoolTest, tasksAddTasks)
+{
+    TaskPool pool(4);
+    for (int run = 0; run < 20; run++) {
+        std::atomic<int> sum{0};
+        add_split(pool, sum, 0, 1000);
+        pool.run();
+        EXPECT_EQ(sum.load(), 999 * 1000 / 2);
+    }
+}
+
+TEST(TaskPoolTest, emptyRun)
+{
+    TaskPool pool(3);
+    pool.run();
+    pool.run();
+    std::atomic<int> count{0};
+    pool.add([&count]() { ++count; });
+    pool.run();
+    EXPECT_EQ(count.load(), 1);
+}
+
+TEST(TaskPoolTest, exceptionRethrownAfterAllTasks)
+{
+    for (int threads : {1, 4}) {
+        TaskPool pool(threads);
+        std::atomic<int> count{0};
+        for (int i = 0; i < 100; i++)
+            pool.add([&count, i]() {
+                ++count;
+                if (i == 10)
+                    throw std::runtime_error("task failed");
+            });
+        EXPECT_THROW(pool.run(), std::runtime_error);
+        EXPECT_EQ(count.load(), 100);
+        // The pool is still usable, and the exception is not thrown again
+        pool.add([&count]() { ++count; });
+        pool.run();
+        EXPECT_EQ(count.load(), 101);
+    }
+}
@@ -0,0 +1,186 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nextpnr.h"
+#include "tile_net_counts.h"
+
+USING_NEXTPNR_NAMESPACE
+
+namespace {
+const int grid_w = 100, grid_h = 100;
+
+// The obvious alternative to TileNetCounts: a hash map per tile
+struct HashTileNetCounts
+{
+    std::vector<std::unordered_map<int, int>> tiles;
+
+    void reset(int width, int height)
+    {
+        tiles.clear();
+        tiles.resize(width * height);
+    }
+
+    int add(Loc loc, int net) { return tiles.at(loc.y * grid_w + loc.x)[net]++; }
+
+    int remove(Loc loc, int net)
+    {
+        auto &tn = tiles.at(loc.y * grid_w + loc.x);
+        auto fnd = tn.find(net);
+        int count = --fnd->second;
+        if (count == 0)
+            tn.erase(fnd);
+        return count;
+    }
+};
+
+// A synthetic placement: cells of six pins each, on nets of mostly nearby cells, about two cells per tile
+struct SyntheticPlacement
+{
+    std::vector<std::vector<int>> cell_nets;
+    std::vector<Loc> cell_loc;
+
+    explicit SyntheticPlacement(uint64_t seed)
+    {
+        DeterministicRNG rng;
+        rng.rngseed(seed);
+        int num_cells = 2 * grid_w * grid_h;
+        cell_nets.resize(num_cells);
+        for (int i = 0; i < num_cells; i++) {
+            // Net i is driven by cell i; the other pins connect to the nets of recent cells
+            cell_nets.at(i).push_back(i);
+            for (int j = 0; j < 5; j++)
+                cell_nets.at(i).push_back(std::max(0, i - 1 - rng.rng(200)));
+            cell_loc.emplace_back((i / 2) % grid_w, (i / 2) / grid_w, 0);
+        }
+    }
+};
+
+// Replay annealer-like moves, each moving a cell to a random tile nearby, returning the net share change. Moves are
+// generated up front so that only the counting is timed.
+struct MoveStream
+{
+    std::vector<std::pair<int, Loc>> moves;
+
+    MoveStream(const SyntheticPlacement &pl, int num_moves, uint64_t seed)
+    {
+        DeterministicRNG rng;
+        rng.rngseed(seed);
+        std::vector<Loc> loc = pl.cell_loc;
+        for (int i = 0; i < num_moves; i++) {
+            int cell = rng.rng(int(loc.size()));
+            Loc old_loc = loc.at(cell);
+            Loc new_loc(std::min(grid_w - 1, std::max(0, old_loc.x + rng.rng(11) - 5)),
+                        std::min(grid_h - 1, std::max(0, old_loc.y + rng.rng(11) - 5)), 0);
+            moves.emplace_back(cell, new_loc);
+            loc.at(cell) = new_loc;
+        }
+    }
+};
+
+template <typename Counts> int setup(Counts &counts, const SyntheticPlacement &pl)
+{
+    counts.reset(grid_w, grid_h);
+    int share = 0;
+    for (size_t i = 0; i < pl.cell_nets.size(); i++)
+        for (int net : pl.cell_nets.at(i))
+            if (counts.add(pl.cell_loc.at(i), net) > 0)
+                ++share;
+    return share;
+}
+
+template <typename Counts>
+int replay(Counts &counts, const SyntheticPlacement &pl, const MoveStream &ms, std::vector<int> *deltas = nullptr)
+{
+    std::vector<Loc> loc = pl.cell_loc;
+    int share = 0;
+    for (auto &move : ms.moves) {
+        int gain = 0, loss = 0;
+        for (int net : pl.cell_nets.at(move.first)) {
+            if (counts.remove(loc.at(move.first), net) > 0)
+                ++loss;
+            if (counts.add(move.second, net) > 0)
+                ++gain;
+        }
+        loc.at(move.first) = move.second;
+        share += gain - loss;
+        if (deltas)
+            deltas->push_back(gain - loss);
+    }
+    return share;
+}
+
+template <typename Counts> double moves_per_sec(const SyntheticPlacement &pl, const MoveStream &ms)
+{
+    Counts counts;
+    setup(counts, pl);
+    auto start = std::chrono::high_resolution_clock::now();
+    replay(counts, pl, ms);
+    auto end = std::chrono::high_resolution_clock::now();
+    return ms.moves.size() / std::chrono::duration<double>(end - start).count();
+}
+} // namespace
+
+TEST(TileNetCountsTest, addAndRemove)
+{
+    TileNetCounts counts;
+    counts.reset(4, 4);
+    Loc a(1, 2, 0), b(3, 0, 0);
+    EXPECT_EQ(counts.add(a, 7), 0);
+    EXPECT_EQ(counts.add(a, 7), 1);
+    EXPECT_EQ(counts.add(a, 3), 0);
+    EXPECT_EQ(counts.add(b, 7), 0);
+    EXPECT_EQ(counts.count(a, 7), 2);
+    EXPECT_EQ(counts.count(a, 3), 1);
+    EXPECT_EQ(counts.count(a, 5), 0);
+    EXPECT_EQ(counts.remove(a, 7), 1);
+    EXPECT_EQ(counts.remove(a, 7), 0);
+    EXPECT_EQ(counts.count(a, 7), 0);
+    EXPECT_EQ(counts.count(b, 7), 1);
+    EXPECT_EQ(counts.add(a, 7), 0);
+}
+
+TEST(TileNetCountsTest, matchesHashMap)
+{
+    SyntheticPlacement pl(1);
+    MoveStream ms(pl, 100000, 2);
+    TileNetCounts counts;
+    HashTileNetCounts hash_counts;
+    EXPECT_EQ(setup(counts, pl), setup(hash_counts, pl));
+    std::vector<int> deltas, hash_deltas;
+    replay(counts, pl, ms, &deltas);
+    replay(hash_counts, pl, ms, &hash_deltas);
+    EXPECT_EQ(deltas, hash_deltas);
+}
+
+TEST(TileNetCountsTest, moveThroughput)
+{
+    SyntheticPlacement pl(3);
+    MoveStream ms(pl, 2000000, 4);
+    double sorted_rate = moves_per_sec<TileNetCounts>(pl, ms);
+    double hash_rate = moves_per_sec<HashTileNetCounts>(pl, ms);
+    printf("Tile net counts over %d moves: sorted arrays %.2fM moves/s, hash maps %.2fM moves/s (%.2fx)\n",
+           int(ms.moves.size()), sorted_rate / 1e6, hash_rate / 1e6, sorted_rate / hash_rate);
+    EXPECT_GT(sorted_rate, 0);
+    EXPECT_GT(hash_rate, 0);
+}
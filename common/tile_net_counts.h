@@ -0,0 +1,88 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef TILE_NET_COUNTS_H
+#define TILE_NET_COUNTS_H
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "nextpnr.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// Number of pins of each net in each tile of the grid, with nets identified by their udata. Tiles only hold a handful
+// of cells, so each is a small array of (net, count) sorted by net rather than a hash map. Different tiles may be
+// updated from different threads at once.
+struct TileNetCounts
+{
+    typedef decltype(NetInfo::udata) NetKey;
+
+    void reset(int width, int height)
+    {
+        grid_width = width;
+        tiles.clear();
+        tiles.resize(width * height);
+    }
+
+    // Add a pin of a net to a tile, returning the number of pins of the net that were already there
+    int add(Loc loc, NetKey net)
+    {
+        auto &tn = tile(loc);
+        auto fnd = find(tn, net);
+        if (fnd == tn.end() || fnd->first != net)
+            fnd = tn.emplace(fnd, net, 0);
+        return fnd->second++;
+    }
+
+    // Remove a pin of a net from a tile, returning the number of pins of the net left there
+    int remove(Loc loc, NetKey net)
+    {
+        auto &tn = tile(loc);
+        auto fnd = find(tn, net);
+        NPNR_ASSERT(fnd != tn.end() && fnd->first == net && fnd->second > 0);
+        int count = --fnd->second;
+        if (count == 0)
+            tn.erase(fnd);
+        return count;
+    }
+
+    int count(Loc loc, NetKey net) const
+    {
+        auto &tn = tiles.at(loc.y * grid_width + loc.x);
+        auto fnd = std::lower_bound(tn.begin(), tn.end(), std::make_pair(net, std::numeric_limits<int>::min()));
+        return (fnd == tn.end() || fnd->first != net) ? 0 : fnd->second;
+    }
+
+  private:
+    typedef std::vector<std::pair<NetKey, int>> TileNets;
+    std::vector<TileNets> tiles;
+    int grid_width = 0;
+
+    TileNets &tile(Loc loc) { return tiles.at(loc.y * grid_width + loc.x); }
+
+    static TileNets::iterator find(TileNets &tn, NetKey net)
+    {
+        return std::lower_bound(tn.begin(), tn.end(), std::make_pair(net, std::numeric_limits<int>::min()));
+    }
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
@@ -26,6 +26,7 @@
 #include <unordered_map>
 #include <utility>
 #include "log.h"
+#include "task_pool.h"
 #include "util.h"
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -267,6 +268,38 @@ struct Timing
                           "timing ports, etc.\n");
         }
 
+        // Net delays are needed several times for each sink below. Following a routed net back from each sink is the
+        // most expensive part of the analysis, so look them all up once beforehand, on several threads
+        std::unordered_map<const NetInfo *, std::vector<delay_t>> route_delays;
+        if (net_delays || net_crit) {
+            std::vector<NetInfo *> delay_nets;
+            for (auto &net : ctx->nets) {
+                route_delays[net.second.get()].resize(net.second->users.size());
+                delay_nets.push_back(net.second.get());
+            }
+            auto lookup_delays = [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    NetInfo *net = delay_nets.at(i);
+                    auto &delays = route_delays.at(net);
+                    for (size_t j = 0; j < net->users.size(); j++)
+                        delays.at(j) = ctx->getNetinfoRouteDelay(net, net->users.at(j));
+                }
+            };
+            int threads = get_thread_count(ctx);
+            const size_t chunk = 512;
+            if (threads > 1 && delay_nets.size() > 4 * chunk) {
+                TaskPool pool(threads);
+                for (size_t i = 0; i < delay_nets.size(); i += chunk)
+                    pool.add([&lookup_delays, &delay_nets, i, chunk]() {
+                        lookup_delays(i, std::min(delay_nets.size(), i + chunk));
+                    });
+                pool.run();
+            } else {
+                lookup_delays(0, delay_nets.size());
+            }
+        }
+        auto route_delay = [&](const NetInfo *net, size_t user) { return route_delays.at(net).at(user); };
+
         // Go forwards topographically to find the maximum arrival time and max path length for each net
         for (auto net : topographical_order) {
             if (!net_data.count(net))
@@ -280,10 +313,11 @@ struct Timing
                 const auto net_arrival = nd.max_arrival;
                 const auto net_length_plus_one = nd.max_path_length + 1;
                 nd.min_remaining_budget = clk_period;
-                for (auto &usr : net->users) {
+                for (size_t i = 0; i < net->users.size(); i++) {
+                    auto &usr = net->users.at(i);
                     int port_clocks;
                     TimingPortClass portClass = ctx->getPortTimingClass(usr.cell, usr.port, port_clocks);
-                    auto net_delay = net_delays ? ctx->getNetinfoRouteDelay(net, usr) : delay_t();
+                    auto net_delay = net_delays ? route_delay(net, i) : delay_t();
                     auto usr_arrival = net_arrival + net_delay;
 
                     if (portClass == TMG_ENDPOINT || portClass == TMG_IGNORE || portClass == TMG_CLOCK_INPUT) {
@@ -328,8 +362,9 @@ struct Timing
                     continue;
                 const delay_t net_length_plus_one = nd.max_path_length + 1;
                 auto &net_min_remaining_budget = nd.min_remaining_budget;
-                for (auto &usr : net->users) {
-                    auto net_delay = net_delays ? ctx->getNetinfoRouteDelay(net, usr) : delay_t();
+                for (size_t i = 0; i < net->users.size(); i++) {
+                    auto &usr = net->users.at(i);
+                    auto net_delay = net_delays ? route_delay(net, i) : delay_t();
                     auto budget_override = ctx->getBudgetOverride(net, usr, net_delay);
                     int port_clocks;
                     TimingPortClass portClass = ctx->getPortTimingClass(usr.cell, usr.port, port_clocks);
@@ -452,9 +487,10 @@ struct Timing
                             net_data.at(port.second.net).count(crit_pair.first.start)) {
                             auto net_arrival = net_data.at(port.second.net).at(crit_pair.first.start).max_arrival;
                             if (net_delays) {
-                                for (auto &user : port.second.net->users)
-                                    if (user.port == port.first && user.cell == crit_net->driver.cell) {
-                                        net_arrival += ctx->getNetinfoRouteDelay(port.second.net, user);
+                                auto &users = port.second.net->users;
+                                for (size_t i = 0; i < users.size(); i++)
+                                    if (users.at(i).port == port.first && users.at(i).cell == crit_net->driver.cell) {
+                                        net_arrival += route_delay(port.second.net, i);
                                         break;
                                     }
                             }
@@ -499,7 +535,7 @@ struct Timing
                     delay_t net_min_required = std::numeric_limits<delay_t>::max();
                     for (size_t i = 0; i < net->users.size(); i++) {
                         auto &usr = net->users.at(i);
-                        auto net_delay = ctx->getNetinfoRouteDelay(net, usr);
+                        auto net_delay = route_delay(net, i);
                         int port_clocks;
                         TimingPortClass portClass = ctx->getPortTimingClass(usr.cell, usr.port, port_clocks);
                         if (portClass == TMG_REGISTER_INPUT || portClass == TMG_ENDPOINT) {
@@ -593,7 +629,7 @@ struct Timing
 #endif
                     for (size_t i = 0; i < net->users.size(); i++) {
                         delay_t slack = nd.min_required.at(i) -
-                                        (nd.max_arrival + ctx->getNetinfoRouteDelay(net, net->users.at(i)));
+                                        (nd.max_arrival + route_delay(net, i));
 #if 0
                         if (ctx->debug)
                             log_info("    user %s.%s required %.02fns arrival %.02f route %.02f slack %.02f\n",
@@ -0,0 +1,559 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "timing_graph.h"
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include "log.h"
+#include "util.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+const delay_t no_arrival = std::numeric_limits<delay_t>::min();
+const delay_t no_required = std::numeric_limits<delay_t>::max();
+// Ranges smaller than this are run on the calling thread, as starting threads would cost more than it saves
+const int min_parallel_range = 4096;
+} // namespace
+
+TimingGraph::TimingGraph(Context *ctx) : ctx(ctx), async_clock(ctx->id("$async$"))
+{
+    threads = get_thread_count(ctx);
+    build();
+    levelise();
+}
+
+void TimingGraph::parallel_for(int begin, int end, const std::function<void(int, int)> &func) const
+{
+    int count = end - begin;
+    if (threads <= 1 || count < min_parallel_range) {
+        func(begin, end);
+        return;
+    }
+    // A few chunks per thread, so that work stealing can even out chunks that take longer
+    int chunk = std::max(min_parallel_range / 4, (count + 4 * threads - 1) / (4 * threads));
+    if (!task_pool)
+        task_pool.reset(new TaskPool(threads));
+    for (int i = begin; i < end; i += chunk) {
+        int chunk_end = std::min(end, i + chunk);
+        task_pool->add([&func, i, chunk_end]() { func(i, chunk_end); });
+    }
+    task_pool->run();
+}
+
+void TimingGraph::build()
+{
+    auto event_index = [&](ClockEvent ev) {
+        auto fnd = std::find(events.begin(), events.end(), ev);
+        if (fnd != events.end())
+            return int(fnd - events.begin());
+        events.push_back(ev);
+        return int(events.size()) - 1;
+    };
+    auto clock_event = [&](CellInfo *cell, const TimingClockingInfo &clk_info) {
+        const NetInfo *clknet = get_net_or_empty(cell, clk_info.clock_port);
+        return event_index(ClockEvent{clknet ? clknet->name : async_clock, clknet ? clk_info.edge : RISING_EDGE});
+    };
+
+    for (auto net : sorted(ctx->nets)) {
+        net_index[net.first] = int(nets.size());
+        nets.push_back(net.second);
+    }
+
+    // Launch events, before conversion to domains
+    std::vector<Launch> launch_events;
+    for (auto net : nets) {
+        launch_start.push_back(int(launch_events.size()));
+        user_start.push_back(int(sink_net.size()));
+        CellInfo *drv = net->driver.cell;
+        int clocks = 0;
+        if (drv != nullptr && ctx->getPortTimingClass(drv, net->driver.port, clocks) == TMG_REGISTER_OUTPUT) {
+            for (int i = 0; i < clocks; i++) {
+                TimingClockingInfo clk_info = ctx->getPortClockingInfo(drv, net->driver.port, i);
+                int ev = clock_event(drv, clk_info);
+                // Paths without a clock are not analysed
+                if (events.at(ev).clock != async_clock)
+                    launch_events.push_back(Launch{ev, clk_info.clockToQ.maxDelay()});
+            }
+        }
+
+        for (auto &usr : net->users) {
+            int sink = int(sink_net.size());
+            sink_net.push_back(net_index.at(net->name));
+            check_start.push_back(int(checks.size()));
+            fanout_start.push_back(int(fanout.size()));
+
+            int usr_clocks = 0;
+            TimingPortClass usr_class = ctx->getPortTimingClass(usr.cell, usr.port, usr_clocks);
+            if (usr_class == TMG_REGISTER_INPUT) {
+                for (int i = 0; i < usr_clocks; i++) {
+                    TimingClockingInfo clk_info = ctx->getPortClockingInfo(usr.cell, usr.port, i);
+                    checks.push_back(SetupCheck{clock_event(usr.cell, clk_info), clk_info.setup.maxDelay()});
+                }
+            } else if (usr_class == TMG_ENDPOINT) {
+                checks.push_back(SetupCheck{event_index(ClockEvent{async_clock, RISING_EDGE}), 0});
+            }
+            if (usr_class == TMG_ENDPOINT || usr_class == TMG_IGNORE || usr_class == TMG_CLOCK_INPUT)
+                continue;
+
+            for (auto &port : usr.cell->ports) {
+                if (port.second.type != PORT_OUT || port.second.net == nullptr)
+                    continue;
+                int port_clocks = 0;
+                TimingPortClass port_class = ctx->getPortTimingClass(usr.cell, port.first, port_clocks);
+                if (port_class == TMG_REGISTER_OUTPUT || port_class == TMG_STARTPOINT || port_class == TMG_IGNORE ||
+                    port_class == TMG_GEN_CLOCK)
+                    continue;
+                DelayInfo comb_delay;
+                if (!ctx->getCellDelay(usr.cell, usr.port, port.first, comb_delay))
+                    continue;
+                fanout.push_back(CellArc{sink, net_index.at(port.second.net->name), comb_delay.maxDelay()});
+            }
+        }
+    }
+    launch_start.push_back(int(launch_events.size()));
+    user_start.push_back(int(sink_net.size()));
+    check_start.push_back(int(checks.size()));
+    fanout_start.push_back(int(fanout.size()));
+
+    // Number the clock domains in order of first launch
+    std::vector<int> event_domain(events.size(), -1);
+    for (auto &l : launch_events) {
+        if (event_domain.at(l.domain) == -1) {
+            event_domain.at(l.domain) = int(domain_event.size());
+            domain_event.push_back(l.domain);
+        }
+        launches.push_back(Launch{event_domain.at(l.domain), l.clk_to_q});
+    }
+    num_domains = int(domain_event.size());
+
+    const delay_t clk_period = ctx->getDelayFromNS(1.0e9 / ctx->setting<float>("target_freq")).maxDelay();
+    for (int d = 0; d < num_domains; d++) {
+        const ClockEvent &launch = events.at(domain_event.at(d));
+        for (auto &capture : events) {
+            delay_t p = (capture.edge == launch.edge) ? clk_period : clk_period / 2;
+            if (capture.clock != async_clock) {
+                auto fnd = ctx->nets.find(capture.clock);
+                if (fnd != ctx->nets.end() && fnd->second->clkconstr) {
+                    auto &constr = fnd->second->clkconstr;
+                    if (capture.edge == launch.edge)
+                        p = constr->period.minDelay();
+                    else if (capture.edge == RISING_EDGE)
+                        p = constr->low.minDelay();
+                    else
+                        p = constr->high.minDelay();
+                }
+            }
+            period.push_back(p);
+        }
+    }
+
+    // Sort the arcs by destination net for the fanin lists
+    fanin_start.assign(nets.size() + 1, 0);
+    for (auto &arc : fanout)
+        ++fanin_start.at(arc.net + 1);
+    for (size_t i = 0; i < nets.size(); i++)
+        fanin_start.at(i + 1) += fanin_start.at(i);
+    std::vector<int> fill(fanin_start.begin(), fanin_start.end() - 1);
+    fanin.resize(fanout.size());
+    for (auto &arc : fanout)
+        fanin.at(fill.at(arc.net)++) = arc;
+
+    sink_delay.resize(sink_net.size(), 0);
+    sink_override.resize(sink_net.size(), 0);
+    arrival.resize(nets.size() * num_domains, no_arrival);
+    path_length.resize(nets.size() * num_domains, 0);
+    required.resize(nets.size() * num_domains, no_required);
+    sink_required.resize(sink_net.size() * num_domains, no_required);
+
+    for (auto &cell : sorted(ctx->cells))
+        cell_bels.emplace_back(cell.second, cell.second->bel);
+}
+
+void TimingGraph::levelise()
+{
+    std::vector<int> pending_fanin(nets.size());
+    std::deque<int> queue;
+    net_level.assign(nets.size(), -1);
+    for (int n = 0; n < int(nets.size()); n++) {
+        pending_fanin.at(n) = fanin_start.at(n + 1) - fanin_start.at(n);
+        if (pending_fanin.at(n) == 0) {
+            net_level.at(n) = 0;
+            queue.push_back(n);
+        }
+    }
+    while (!queue.empty()) {
+        int n = queue.front();
+        queue.pop_front();
+        topo_order.push_back(n);
+        for (int s = user_start.at(n); s < user_start.at(n + 1); s++)
+            for (int a = fanout_start.at(s); a < fanout_start.at(s + 1); a++) {
+                int to = fanout.at(a).net;
+                net_level.at(to) = std::max(net_level.at(to), net_level.at(n) + 1);
+                if (--pending_fanin.at(to) == 0)
+                    queue.push_back(to);
+            }
+    }
+
+    if (topo_order.size() < nets.size()) {
+        for (int n = 0; n < int(nets.size()); n++)
+            if (pending_fanin.at(n) > 0) {
+                // Nets in or after a loop are left out
+                net_level.at(n) = -1;
+                if (ctx->debug)
+                    log_info("   net %s is in a combinational loop\n", ctx->nameOf(nets.at(n)));
+            }
+        if (!bool_or_default(ctx->settings, ctx->id("timing/ignoreLoops"), false)) {
+            if (ctx->force)
+                log_warning("timing analysis failed due to presence of combinatorial loops, incomplete specification "
+                            "of timing ports, etc.\n");
+            else
+                log_error("timing analysis failed due to presence of combinatorial loops, incomplete specification of "
+                          "timing ports, etc.\n");
+        }
+    }
+
+    std::stable_sort(topo_order.begin(), topo_order.end(),
+                     [&](int a, int b) { return net_level.at(a) < net_level.at(b); });
+    num_levels = topo_order.empty() ? 0 : (net_level.at(topo_order.back()) + 1);
+    level_start.assign(num_levels + 1, 0);
+    for (int n : topo_order)
+        ++level_start.at(net_level.at(n) + 1);
+    for (int l = 0; l < num_levels; l++)
+        level_start.at(l + 1) += level_start.at(l);
+}
+
+bool TimingGraph::update_sink(int sink)
+{
+    NetInfo *net = nets.at(sink_net.at(sink));
+    const PortRef &usr = net->users.at(sink - user_start.at(sink_net.at(sink)));
+    delay_t delay = ctx->getNetinfoRouteDelay(net, usr);
+    delay_t budget = delay;
+    uint8_t override = ctx->getBudgetOverride(net, usr, budget) ? 1 : 0;
+    if (delay == sink_delay.at(sink) && override == sink_override.at(sink))
+        return false;
+    sink_delay.at(sink) = delay;
+    sink_override.at(sink) = override;
+    return true;
+}
+
+void TimingGraph::update_sinks(const std::vector<int> &sinks, std::vector<int> &changed_sinks)
+{
+    std::vector<uint8_t> changed(sinks.size(), 0);
+    parallel_for(0, int(sinks.size()), [&](int begin, int end) {
+        for (int i = begin; i < end; i++)
+            changed.at(i) = update_sink(sinks.at(i));
+    });
+    for (size_t i = 0; i < sinks.size(); i++)
+        if (changed.at(i))
+            changed_sinks.push_back(sinks.at(i));
+}
+
+void TimingGraph::compute_arrival(int net, std::vector<delay_t> &new_arrival, std::vector<int> &new_length) const
+{
+    std::fill(new_arrival.begin(), new_arrival.end(), no_arrival);
+    std::fill(new_length.begin(), new_length.end(), 0);
+    for (int i = launch_start.at(net); i < launch_start.at(net + 1); i++) {
+        auto &l = launches.at(i);
+        new_arrival.at(l.domain) = std::max(new_arrival.at(l.domain), l.clk_to_q);
+    }
+    for (int a = fanin_start.at(net); a < fanin_start.at(net + 1); a++) {
+        auto &arc = fanin.at(a);
+        int from = sink_net.at(arc.sink);
+        for (int d = 0; d < num_domains; d++) {
+            delay_t from_arrival = arrival.at(from * num_domains + d);
+            if (from_arrival == no_arrival)
+                continue;
+            new_arrival.at(d) = std::max(new_arrival.at(d), from_arrival + sink_delay.at(arc.sink) + arc.delay);
+            // Arcs from sinks with an overridden budget don't take a share of the path slack
+            new_length.at(d) = std::max(new_length.at(d),
+                                        path_length.at(from * num_domains + d) + (sink_override.at(arc.sink) ? 0 : 1));
+        }
+    }
+}
+
+void TimingGraph::compute_required(int net, std::vector<delay_t> &new_required)
+{
+    std::fill(new_required.begin(), new_required.end(), no_required);
+    for (int s = user_start.at(net); s < user_start.at(net + 1); s++) {
+        for (int d = 0; d < num_domains; d++) {
+            delay_t req = no_required;
+            for (int c = check_start.at(s); c < check_start.at(s + 1); c++)
+                req = std::min(req, period.at(d * events.size() + checks.at(c).event) - checks.at(c).setup);
+            for (int a = fanout_start.at(s); a < fanout_start.at(s + 1); a++) {
+                delay_t to_required = required.at(fanout.at(a).net * num_domains + d);
+                if (to_required != no_required)
+                    req = std::min(req, to_required - fanout.at(a).delay);
+            }
+            sink_required.at(s * num_domains + d) = req;
+            if (req != no_required)
+                new_required.at(d) = std::min(new_required.at(d), req - sink_delay.at(s));
+        }
+    }
+}
+
+void TimingGraph::update_all()
+{
+    parallel_for(0, int(sink_net.size()), [&](int begin, int end) {
+        for (int s = begin; s < end; s++)
+            update_sink(s);
+    });
+
+    for (int level = 0; level < num_levels; level++)
+        parallel_for(level_start.at(level), level_start.at(level + 1), [&](int begin, int end) {
+            std::vector<delay_t> values(num_domains);
+            std::vector<int> lengths(num_domains);
+            for (int i = begin; i < end; i++) {
+                int n = topo_order.at(i);
+                compute_arrival(n, values, lengths);
+                std::copy(values.begin(), values.end(), arrival.begin() + n * num_domains);
+                std::copy(lengths.begin(), lengths.end(), path_length.begin() + n * num_domains);
+            }
+        });
+    for (int level = num_levels - 1; level >= 0; level--)
+        parallel_for(level_start.at(level), level_start.at(level + 1), [&](int begin, int end) {
+            std::vector<delay_t> values(num_domains);
+            for (int i = begin; i < end; i++) {
+                int n = topo_order.at(i);
+                compute_required(n, values);
+                std::copy(values.begin(), values.end(), required.begin() + n * num_domains);
+            }
+        });
+
+    for (auto &cb : cell_bels)
+        cb.second = cb.first->bel;
+}
+
+int TimingGraph::update_placement()
+{
+    std::vector<int> sinks, changed_sinks;
+    std::vector<uint8_t> seen_net(nets.size(), 0);
+    int moved = 0;
+    for (auto &cb : cell_bels) {
+        if (cb.first->bel == cb.second)
+            continue;
+        cb.second = cb.first->bel;
+        ++moved;
+        for (auto &port : cb.first->ports) {
+            if (port.second.net == nullptr)
+                continue;
+            int n = net_index.at(port.second.net->name);
+            if (seen_net.at(n))
+                continue;
+            seen_net.at(n) = 1;
+            for (int s = user_start.at(n); s < user_start.at(n + 1); s++)
+                sinks.push_back(s);
+        }
+    }
+    update_sinks(sinks, changed_sinks);
+    propagate(changed_sinks);
+    if (ctx->debug)
+        check_incremental();
+    return moved;
+}
+
+int TimingGraph::update_nets(const std::vector<NetInfo *> &changed)
+{
+    std::vector<int> sinks, changed_sinks;
+    for (auto net : changed) {
+        int n = net_index.at(net->name);
+        for (int s = user_start.at(n); s < user_start.at(n + 1); s++)
+            sinks.push_back(s);
+    }
+    update_sinks(sinks, changed_sinks);
+    propagate(changed_sinks);
+    if (ctx->debug)
+        check_incremental();
+    return int(changed_sinks.size());
+}
+
+void TimingGraph::check_incremental() const
+{
+    // Verify correctness of incremental updates against a full update of a fresh graph
+    TimingGraph gold(ctx);
+    gold.update_all();
+    NPNR_ASSERT(gold.sink_net == sink_net);
+    NPNR_ASSERT(gold.sink_delay == sink_delay);
+    NPNR_ASSERT(gold.arrival == arrival);
+    NPNR_ASSERT(gold.path_length == path_length);
+    NPNR_ASSERT(gold.required == required);
+    NPNR_ASSERT(gold.sink_required == sink_required);
+}
+
+void TimingGraph::propagate(const std::vector<int> &changed_sinks)
+{
+    // Nets to revisit, bucketed by level so that each is only recomputed once all of its inputs are final
+    std::vector<std::vector<int>> fwd_queue(num_levels), bwd_queue(num_levels);
+    std::vector<uint8_t> fwd_queued(nets.size(), 0), bwd_queued(nets.size(), 0);
+    auto queue_fwd = [&](int n) {
+        if (net_level.at(n) == -1 || fwd_queued.at(n))
+            return;
+        fwd_queued.at(n) = 1;
+        fwd_queue.at(net_level.at(n)).push_back(n);
+    };
+    auto queue_bwd = [&](int n) {
+        if (net_level.at(n) == -1 || bwd_queued.at(n))
+            return;
+        bwd_queued.at(n) = 1;
+        bwd_queue.at(net_level.at(n)).push_back(n);
+    };
+
+    // A changed sink delay moves the arrival times of the nets after it, and the required time of its own net
+    for (int s : changed_sinks) {
+        for (int a = fanout_start.at(s); a < fanout_start.at(s + 1); a++)
+            queue_fwd(fanout.at(a).net);
+        queue_bwd(sink_net.at(s));
+    }
+
+    // Each level is recomputed, possibly on several threads, before queueing the nets affected by its changes
+    std::vector<uint8_t> changed;
+    for (int level = 0; level < num_levels; level++) {
+        auto &queue = fwd_queue.at(level);
+        changed.assign(queue.size(), 0);
+        parallel_for(0, int(queue.size()), [&](int begin, int end) {
+            std::vector<delay_t> values(num_domains);
+            std::vector<int> lengths(num_domains);
+            for (int i = begin; i < end; i++) {
+                int n = queue.at(i);
+                compute_arrival(n, values, lengths);
+                auto old_begin = arrival.begin() + n * num_domains;
+                auto old_length = path_length.begin() + n * num_domains;
+                if (std::equal(values.begin(), values.end(), old_begin) &&
+                    std::equal(lengths.begin(), lengths.end(), old_length))
+                    continue;
+                std::copy(values.begin(), values.end(), old_begin);
+                std::copy(lengths.begin(), lengths.end(), old_length);
+                changed.at(i) = 1;
+            }
+        });
+        for (size_t i = 0; i < queue.size(); i++) {
+            if (!changed.at(i))
+                continue;
+            int n = queue.at(i);
+            for (int s = user_start.at(n); s < user_start.at(n + 1); s++)
+                for (int a = fanout_start.at(s); a < fanout_start.at(s + 1); a++)
+                    queue_fwd(fanout.at(a).net);
+        }
+    }
+    for (int level = num_levels - 1; level >= 0; level--) {
+        auto &queue = bwd_queue.at(level);
+        changed.assign(queue.size(), 0);
+        parallel_for(0, int(queue.size()), [&](int begin, int end) {
+            std::vector<delay_t> values(num_domains);
+            for (int i = begin; i < end; i++) {
+                int n = queue.at(i);
+                compute_required(n, values);
+                auto old_begin = required.begin() + n * num_domains;
+                if (std::equal(values.begin(), values.end(), old_begin))
+                    continue;
+                std::copy(values.begin(), values.end(), old_begin);
+                changed.at(i) = 1;
+            }
+        });
+        for (size_t i = 0; i < queue.size(); i++) {
+            if (!changed.at(i))
+                continue;
+            int n = queue.at(i);
+            for (int a = fanin_start.at(n); a < fanin_start.at(n + 1); a++)
+                queue_bwd(sink_net.at(fanin.at(a).sink));
+        }
+    }
+}
+
+void TimingGraph::get_domain_delays(std::vector<delay_t> &crit_delay, std::vector<delay_t> &worst_slack) const
+{
+    crit_delay.assign(num_domains, no_arrival);
+    worst_slack.assign(num_domains, no_required);
+    // Each chunk of sinks finds its own maxima and minima, and then merges them in
+    std::mutex merge_mutex;
+    parallel_for(0, int(sink_net.size()), [&](int begin, int end) {
+        std::vector<delay_t> chunk_delay(num_domains, no_arrival), chunk_slack(num_domains, no_required);
+        for (int s = begin; s < end; s++) {
+            int n = sink_net.at(s);
+            for (int d = 0; d < num_domains; d++) {
+                delay_t arr = arrival.at(n * num_domains + d);
+                if (arr == no_arrival)
+                    continue;
+                arr += sink_delay.at(s);
+                for (int c = check_start.at(s); c < check_start.at(s + 1); c++)
+                    if (checks.at(c).event == domain_event.at(d))
+                        chunk_delay.at(d) = std::max(chunk_delay.at(d), arr + checks.at(c).setup);
+                delay_t req = sink_required.at(s * num_domains + d);
+                if (req != no_required)
+                    chunk_slack.at(d) = std::min(chunk_slack.at(d), req - arr);
+            }
+        }
+        std::lock_guard<std::mutex> lock(merge_mutex);
+        for (int d = 0; d < num_domains; d++) {
+            crit_delay.at(d) = std::max(crit_delay.at(d), chunk_delay.at(d));
+            worst_slack.at(d) = std::min(worst_slack.at(d), chunk_slack.at(d));
+        }
+    });
+}
+
+delay_t TimingGraph::get_critical_path_delay() const
+{
+    std::vector<delay_t> crit_delay, worst_slack;
+    get_domain_delays(crit_delay, worst_slack);
+    delay_t worst = 0;
+    for (auto d : crit_delay)
+        worst = std::max(worst, d);
+    return worst;
+}
+
+void TimingGraph::get_criticalities(NetCriticalityMap *net_crit) const
+{
+    net_crit->clear();
+    std::vector<delay_t> crit_delay, worst_slack;
+    get_domain_delays(crit_delay, worst_slack);
+
+    for (int n = 0; n < int(nets.size()); n++) {
+        bool reached = false;
+        for (int d = 0; d < num_domains; d++)
+            reached |= (arrival.at(n * num_domains + d) != no_arrival);
+        if (!reached)
+            continue;
+        auto &nc = (*net_crit)[nets.at(n)->name];
+        int num_users = user_start.at(n + 1) - user_start.at(n);
+        nc.slack.resize(num_users, std::numeric_limits<delay_t>::max());
+        nc.criticality.resize(num_users, 0);
+        for (int i = 0; i < num_users; i++) {
+            int s = user_start.at(n) + i;
+            for (int d = 0; d < num_domains; d++) {
+                delay_t arr = arrival.at(n * num_domains + d);
+                delay_t req = sink_required.at(s * num_domains + d);
+                if (arr == no_arrival || req == no_required)
+                    continue;
+                delay_t slack = req - (arr + sink_delay.at(s));
+                nc.slack.at(i) = std::min(nc.slack.at(i), slack);
+                nc.cd_worst_slack = std::min(nc.cd_worst_slack, worst_slack.at(d));
+                nc.max_path_length = std::max<unsigned>(nc.max_path_length, path_length.at(n * num_domains + d));
+                if (crit_delay.at(d) <= 0)
+                    continue;
+                float criticality =
+                        1.0f - ((float(slack) - float(worst_slack.at(d))) / float(crit_delay.at(d)));
+                nc.criticality.at(i) = std::max<float>(nc.criticality.at(i),
+                                                       std::min<double>(1.0, std::max<double>(0.0, criticality)));
+            }
+        }
+    }
+}
+
+NEXTPNR_NAMESPACE_END
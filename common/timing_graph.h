@@ -0,0 +1,152 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef TIMING_GRAPH_H
+#define TIMING_GRAPH_H
+
+#include <functional>
+#include <memory>
+#include "nextpnr.h"
+#include "task_pool.h"
+#include "timing.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+// A timing graph of the netlist that is kept between analyses, so that criticalities can be updated after a
+// placement change by re-propagating arrival times through the fanout cones, and required times through the fanin
+// cones, of only the nets whose delays changed.
+//
+// Nodes are nets, holding the latest arrival time at the driver and the earliest required time there for each clock
+// domain. Each user of a net is a sink with the current net delay to it, and edges lead from a sink through a
+// combinational cell arc to the net driven by the cell output. Everything is stored in flat arrays indexed by net
+// and sink number, with nets in levelised topological order.
+//
+// Only paths launched by clocked register outputs are analysed, giving the same criticalities as get_criticalities()
+// for intra-clock paths. Budgets are not updated. The netlist itself must not change while the graph is in use, but
+// placement and routing may: after either, only the nets whose delays changed need to be passed back in.
+//
+// The nets of each level only depend on those of earlier levels, so large levels are propagated on several threads,
+// with a barrier between levels. Delays are integers, so the results don't depend on the number of threads.
+struct TimingGraph
+{
+    explicit TimingGraph(Context *ctx);
+
+    // Recompute every net delay and propagate through the whole graph
+    void update_all();
+    // Recompute the delays of nets connected to cells whose bel changed since the last update, and propagate only
+    // through the affected cones. Returns the number of cells that moved.
+    int update_placement();
+    // Recompute the delays of the given nets, for example after they were rerouted, and propagate only through the
+    // affected cones. Returns the number of sinks whose delay changed.
+    int update_nets(const std::vector<NetInfo *> &changed);
+
+    // Fill in criticalities, in the same format as get_criticalities()
+    void get_criticalities(NetCriticalityMap *net_crit) const;
+    // The delay of the longest path within any clock domain, including clock-to-out and setup times
+    delay_t get_critical_path_delay() const;
+
+  private:
+    struct ClockEvent
+    {
+        IdString clock;
+        ClockEdge edge;
+        bool operator==(const ClockEvent &other) const { return clock == other.clock && edge == other.edge; }
+    };
+    // A combinational arc through a cell, from a sink of one net to the driver of another
+    struct CellArc
+    {
+        int sink, net;
+        delay_t delay;
+    };
+    // A setup check at a sink, against a clock event
+    struct SetupCheck
+    {
+        int event;
+        delay_t setup;
+    };
+    // The launch of a clock domain at a register output
+    struct Launch
+    {
+        int domain;
+        delay_t clk_to_q;
+    };
+
+    Context *ctx;
+    IdString async_clock;
+    int threads;
+    // Threads for parallel_for, started on the first large enough range and kept for the life of the graph
+    mutable std::unique_ptr<TaskPool> task_pool;
+
+    std::vector<ClockEvent> events;
+    // Events launching register paths, which are the clock domains analysed
+    std::vector<int> domain_event;
+    int num_domains = 0;
+    // Setup period for a path from domain d to the clock event e, at period[d * events.size() + e]
+    std::vector<delay_t> period;
+
+    std::vector<NetInfo *> nets;
+    std::unordered_map<IdString, int> net_index;
+    // Nets in topological order, and the level of each net; -1 for nets in combinational loops, which are ignored
+    std::vector<int> topo_order;
+    std::vector<int> net_level;
+    int num_levels = 0;
+    // Nets of level l are topo_order[level_start[l]] to topo_order[level_start[l + 1] - 1]
+    std::vector<int> level_start;
+
+    // Sinks of net n are user_start[n] to user_start[n + 1] - 1, in the order of NetInfo::users
+    std::vector<int> user_start;
+    std::vector<int> sink_net;
+    std::vector<delay_t> sink_delay;
+    // Whether the delay budget of each sink is overridden by the Arch, so that it doesn't count towards path length
+    std::vector<uint8_t> sink_override;
+
+    // Arcs leaving each sink, and arcs entering each net, in CSR form
+    std::vector<int> fanout_start, fanin_start;
+    std::vector<CellArc> fanout, fanin;
+    std::vector<int> check_start, launch_start;
+    std::vector<SetupCheck> checks;
+    std::vector<Launch> launches;
+
+    // Per net, or per sink, and domain; at [index * num_domains + domain]
+    std::vector<delay_t> arrival, required, sink_required;
+    // Number of nets on the longest path, by net count, from a launch to each net; at [net * num_domains + domain]
+    std::vector<int> path_length;
+
+    // Bel of each cell at the last update, to find the cells that moved
+    std::vector<std::pair<CellInfo *, BelId>> cell_bels;
+
+    // The longest path, and the worst slack, in each domain
+    void get_domain_delays(std::vector<delay_t> &crit_delay, std::vector<delay_t> &worst_slack) const;
+    void build();
+    void levelise();
+    // Run func over chunks of the range [begin, end), on several threads if the range is large enough
+    void parallel_for(int begin, int end, const std::function<void(int, int)> &func) const;
+    bool update_sink(int sink);
+    // Update the delays of the given sinks, adding those that changed to changed_sinks
+    void update_sinks(const std::vector<int> &sinks, std::vector<int> &changed_sinks);
+    void compute_arrival(int net, std::vector<delay_t> &new_arrival, std::vector<int> &new_length) const;
+    void compute_required(int net, std::vector<delay_t> &new_required);
+    void propagate(const std::vector<int> &changed_sinks);
+    // With ctx->debug, incremental updates are compared with update_all() on a fresh graph
+    void check_incremental() const;
+};
+
+NEXTPNR_NAMESPACE_END
+
+#endif
@@ -33,6 +33,7 @@
 #include <queue>
 #include "nextpnr.h"
 #include "timing.h"
+#include "timing_graph.h"
 #include "util.h"
 
 namespace std {
@@ -88,7 +89,7 @@ class TimingOptimiser
             timing_analysis(ctx, false, true, false, false);
         for (int i = 0; i < 30; i++) {
             log_info("   Iteration %d...\n", i);
-            get_criticalities(ctx, &net_crit);
+            update_criticalities();
             setup_delay_limits();
             auto crit_paths = find_crit_paths(0.98, 50000);
             for (auto &path : crit_paths)
@@ -101,6 +102,17 @@ class TimingOptimiser
     }
 
   private:
+    void update_criticalities()
+    {
+        if (timing_graph == nullptr) {
+            timing_graph.reset(new TimingGraph(ctx));
+            timing_graph->update_all();
+        } else {
+            timing_graph->update_placement();
+        }
+        timing_graph->get_criticalities(&net_crit);
+    }
+
     void setup_delay_limits()
     {
         max_net_delay.clear();
@@ -614,8 +626,9 @@ class TimingOptimiser
     std::unordered_map<BelId, std::unordered_set<IdString>> bel_candidate_cells;
     // Map cell ports to net delay limit
     std::unordered_map<std::pair<IdString, IdString>, delay_t> max_net_delay;
-    // Criticality data from timing analysis
+    // Criticality data from timing analysis, kept up to date incrementally as cells are moved
     NetCriticalityMap net_crit;
+    std::unique_ptr<TimingGraph> timing_graph;
     Context *ctx;
     TimingOptCfg cfg;
 };
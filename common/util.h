@@ -23,6 +23,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <thread>
 #include "nextpnr.h"
 
 NEXTPNR_NAMESPACE_BEGIN
@@ -130,6 +131,14 @@ inline NetInfo *get_net_or_empty(CellInfo *cell, const IdString port)
         return nullptr;
 }
 
+// Number of threads for parallel work: the "threads" setting if given, otherwise the number of hardware threads
+inline int get_thread_count(const Context *ctx)
+{
+    if (ctx->settings.count(ctx->id("threads")))
+        return std::max(1, int_or_default(ctx->settings, ctx->id("threads"), 1));
+    return std::max(1, int(std::thread::hardware_concurrency()));
+}
+
 NEXTPNR_NAMESPACE_END
 
 #endif
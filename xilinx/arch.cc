@@ -23,6 +23,7 @@
 #include <boost/range/adaptor/reversed.hpp>
 #include <cmath>
 #include <cstring>
+#include <map>
 #include <queue>
 #include "log.h"
 #include "nextpnr.h"
@@ -93,6 +94,8 @@ Arch::Arch(ArchArgs args) : args(args)
         tileStatus[i].sitevariant.resize(chip_info->tile_insts[i].num_sites);
     }
 
+    setup_wire_index();
+
     if (xc7)
         setup_pip_blacklist();
 }
@@ -254,6 +257,54 @@ WireId Arch::getWireByName(IdString name) const
     return ret;
 }
 
+void Arch::setup_wire_index()
+{
+    wire_index_tile_start.reserve(chip_info->num_tiles + 1);
+    int32_t count = chip_info->num_nodes;
+    for (int i = 0; i < chip_info->num_tiles; i++) {
+        auto &tile = chip_info->tile_insts[i];
+        int num_wires = chip_info->tile_types[tile.type].num_wires;
+        wire_index_tile_start.push_back(int32_t(wire_index_bits.size()));
+        for (int j = 0; j < num_wires; j += 64) {
+            uint64_t bits = 0;
+            for (int k = j; k < std::min(j + 64, num_wires); k++)
+                if (k >= tile.num_tile_wires || tile.tile_wire_to_node[k] == -1)
+                    bits |= (uint64_t(1) << (k - j));
+            wire_index_bits.push_back(bits);
+            wire_index_rank.push_back(count);
+            count += int32_t(std::bitset<64>(bits).count());
+        }
+    }
+    wire_index_tile_start.push_back(int32_t(wire_index_bits.size()));
+    wire_index_rank.push_back(count);
+}
+
+WireId Arch::getWireByIndex(int index) const
+{
+    WireId ret;
+    NPNR_ASSERT(index >= 0 && index < getNumWires());
+    if (index < chip_info->num_nodes) {
+        ret.tile = -1;
+        ret.index = index;
+        return ret;
+    }
+    // Last word whose first set bit is at or before index; the following word starts after it, so index is in this one
+    int word = int(std::upper_bound(wire_index_rank.begin(), wire_index_rank.end() - 1, index) -
+                   wire_index_rank.begin()) -
+               1;
+    ret.tile = int(std::upper_bound(wire_index_tile_start.begin(), wire_index_tile_start.end(), word) -
+                   wire_index_tile_start.begin()) -
+               1;
+    uint64_t bits = wire_index_bits[word];
+    for (int skip = index - wire_index_rank[word]; skip > 0; skip--)
+        bits &= bits - 1;
+    int bit = 0;
+    while (!(bits & (uint64_t(1) << bit)))
+        bit++;
+    ret.index = (word - wire_index_tile_start[ret.tile]) * 64 + bit;
+    return ret;
+}
+
 IdString Arch::getWireType(WireId wire) const { return IdString(wireIntent(wire)); }
 std::vector<std::pair<IdString, std::string>> Arch::getWireAttrs(WireId wire) const
 {
@@ -462,6 +513,23 @@ delay_t Arch::estimateDelay(WireId src, WireId dst, bool debug) const
         dst_y = dst_tile / chip_info->width;
     }
 
+    if (lookahead.ready() && !sink_locs.count(dst) && dst.tile != -1 && wireInfo(dst).site != -1 &&
+        src_intent != ID_PSEUDO_GND && src_intent != ID_PSEUDO_VCC) {
+        // The table is indexed relative to the anchor tile of the source, and extended linearly outside its window
+        int dx = dst_x - src_tile % chip_info->width, dy = dst_y - src_tile / chip_info->width;
+        int max_dx = lookahead.header->max_dx, max_dy = lookahead.header->max_dy;
+        int cx = std::max(-max_dx, std::min(dx, max_dx)), cy = std::max(-max_dy, std::min(dy, max_dy));
+        delay_t table = lookahead.query(chip_info->tile_insts[src_tile].type, src_intent, cx, cy);
+        if (table != -1) {
+            delay_t outside = 10 * (std::abs(dx) - std::abs(cx)) + 20 * (std::abs(dy) - std::abs(cy));
+            if (xc7)
+                outside = (outside * 3) / 2;
+            if (debug)
+                log_info("    lookahead (%d, %d): %d + %d\n", dx, dy, table, outside);
+            return table + outside;
+        }
+    }
+
     if (src.tile == -1) {
         if (src_intent == ID_PSEUDO_GND || src_intent == ID_PSEUDO_VCC) {
             if (gnd_glbl == IdString()) {
@@ -620,6 +688,19 @@ delay_t Arch::predictDelay(const NetInfo *net_info, const PortRef &sink) const
             return 700; // penalize FF2 as it makes routing harder
         else
             return 150;
+    } else if (place_delays.ready() &&
+               place_delays.tile_type_class[chip_info->tile_insts[net_info->driver.cell->bel.tile].type] != -1) {
+        // Offsets in the table are to the interconnect tile of the sink's site, as for the routing lookahead
+        int cls = place_delays.tile_type_class[chip_info->tile_insts[net_info->driver.cell->bel.tile].type];
+        int site = locInfo(sink.cell->bel).bel_data[sink.cell->bel.index].site;
+        if (site >= 0) {
+            auto &si = chip_info->tile_insts[sink.cell->bel.tile].site_insts[site];
+            if (si.inter_x != -1) {
+                dst_x = si.inter_x;
+                dst_y = si.inter_y;
+            }
+        }
+        return place_delays.query(cls, dst_x - src_x, dst_y - src_y);
     } else {
         delay_t base = 30 * std::min(std::abs(dst_x - src_x), 18) + 10 * std::max(std::abs(dst_x - src_x) - 18, 0) +
                        60 * std::min(std::abs(dst_y - src_y), 6) + 20 * std::max(std::abs(dst_y - src_y) - 6, 0) + 300;
@@ -634,9 +715,49 @@ bool Arch::getBudgetOverride(const NetInfo *net_info, const PortRef &sink, delay
 
 // -----------------------------------------------------------------------
 
+std::vector<Arch::SlrInfo> Arch::getSlrs() const
+{
+    // Laguna registers per row
+    std::map<int, int> laguna_rows;
+    IdString laguna_reg = id("LAGUNA_REGX");
+    for (int tile = 0; tile < chip_info->num_tiles; tile++) {
+        auto &tt = chip_info->tile_types[chip_info->tile_insts[tile].type];
+        if (IdString(tt.type).str(this).compare(0, 6, "LAGUNA") != 0)
+            continue;
+        int &regs = laguna_rows[tile / chip_info->width];
+        for (int i = 0; i < tt.num_bels; i++)
+            if (IdString(tt.bel_data[i].type) == laguna_reg)
+                ++regs;
+    }
+
+    // Laguna rows either side of a boundary are contiguous, and far from those of any other boundary; the boundary is
+    // taken to be midway through each group of rows
+    const int max_group_gap = 30;
+    std::vector<SlrInfo> slrs;
+    int y0 = 0;
+    auto it = laguna_rows.begin();
+    while (it != laguna_rows.end()) {
+        int first = it->first, last = it->first, regs = 0;
+        for (; it != laguna_rows.end() && it->first - last <= max_group_gap; ++it) {
+            last = it->first;
+            regs += it->second;
+        }
+        if (first == 0 || last == chip_info->height - 1)
+            continue;
+        int boundary = (first + last) / 2;
+        slrs.push_back(SlrInfo{y0, boundary, regs / 2});
+        y0 = boundary + 1;
+    }
+    slrs.push_back(SlrInfo{y0, chip_info->height - 1, 0});
+    return slrs;
+}
+
+// -----------------------------------------------------------------------
+
 bool Arch::place()
 {
     std::string placer = str_or_default(settings, id("placer"), defaultPlacer);
+    setupPlaceDelays();
 
     if (placer == "heap") {
         PlacerHeapCfg cfg(getCtx());
@@ -752,7 +873,9 @@ void Arch::routeClock()
         if (!is_global)
             continue;
         log_info("    routing clock '%s'\n", ni->name.c_str(this));
-        bindWire(getCtx()->getNetinfoSourceWire(ni), ni, STRENGTH_LOCKED);
+        // The clock may already be routed, when routing a design loaded with its existing routing
+        if (getBoundWireNet(getCtx()->getNetinfoSourceWire(ni)) != ni)
+            bindWire(getCtx()->getNetinfoSourceWire(ni), ni, STRENGTH_LOCKED);
         for (auto &usr : ni->users) {
             std::queue<WireId> visit;
             std::unordered_map<WireId, PipId> backtrace;
@@ -979,11 +1102,14 @@ void Arch::findSourceSinkLocations()
 bool Arch::route()
 {
     assign_budget(getCtx(), true);
+    // The routers bind from several threads at once, which needs the binding state to exist beforehand
+    setupWireBindings();
     std::string router = str_or_default(settings, id("router"), defaultRouter);
     if (router != "router2")
         routeVcc();
     routeClock();
     findSourceSinkLocations();
+    setupLookahead();
 
     bool result;
     if (router == "router1") {
@@ -25,7 +25,9 @@
 
 #include <boost/iostreams/device/mapped_file.hpp>
 
+#include <bitset>
 #include <iostream>
+#include <tuple>
 
 NEXTPNR_NAMESPACE_BEGIN
 
@@ -323,6 +325,71 @@ NPNR_PACKED_STRUCT(struct ChipInfoPOD {
 
 /************************ End of chipdb section. ************************/
 
+// Routing lookahead cache file, see lookahead.cc. Following the header are int32 arrays of:
+//  - the intent constid for each of num_intents dense intent indices
+//  - the class index (or -1) for each tile type and dense intent index
+//  - for each class, the delay (or -1) for each dy in [-max_dy, max_dy] and dx in [-max_dx, max_dx]
+NPNR_PACKED_STRUCT(struct LookaheadHeaderPOD {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t chipdb_hash;
+    int32_t num_tile_types;
+    int32_t num_intents;
+    int32_t num_classes;
+    int32_t max_dx, max_dy;
+    int32_t padding;
+});
+
+struct RouteLookahead
+{
+    // Either a mapped cache file, or a table built during this run
+    boost::iostreams::mapped_file_source file;
+    std::vector<int32_t> built;
+
+    const LookaheadHeaderPOD *header = nullptr;
+    const int32_t *intents = nullptr, *class_map = nullptr, *delays = nullptr;
+    // Intent constid to dense intent index, or -1
+    std::vector<int32_t> intent_idx;
+
+    bool ready() const { return header != nullptr; }
+
+    // Delay from a wire of the given anchor tile type and intent to a site wire at an offset inside the window,
+    // or -1 if there is no data
+    int32_t query(int tile_type, int intent, int dx, int dy) const
+    {
+        if (intent < 0 || intent >= int(intent_idx.size()) || intent_idx[intent] == -1)
+            return -1;
+        int cls = class_map[tile_type * header->num_intents + intent_idx[intent]];
+        if (cls == -1)
+            return -1;
+        int width = 2 * header->max_dx + 1, height = 2 * header->max_dy + 1;
+        return delays[(cls * height + (dy + header->max_dy)) * width + (dx + header->max_dx)];
+    }
+};
+
+// Placement delay model, see lookahead.cc. For each class of source tile type, the predicted delay from a Bel output in
+// it to a sink whose interconnect tile is at each offset inside a window, extended linearly outside it
+struct PlaceDelayTable
+{
+    int max_dx = 0, max_dy = 0;
+    // Delay per tile beyond the window
+    delay_t outside_x = 0, outside_y = 0;
+    // Class of each tile type, or -1 if there is no data
+    std::vector<int32_t> tile_type_class;
+    // For each class, the delay for each dy in [-max_dy, max_dy] and dx in [-max_dx, max_dx]
+    std::vector<delay_t> delays;
+
+    bool ready() const { return !delays.empty(); }
+
+    delay_t query(int cls, int dx, int dy) const
+    {
+        int cx = std::max(-max_dx, std::min(dx, max_dx)), cy = std::max(-max_dy, std::min(dy, max_dy));
+        int width = 2 * max_dx + 1, height = 2 * max_dy + 1;
+        return delays[(cls * height + (cy + max_dy)) * width + (cx + max_dx)] +
+               outside_x * (std::abs(dx) - std::abs(cx)) + outside_y * (std::abs(dy) - std::abs(cy));
+    }
+};
+
 struct BelIterator
 {
     const ChipInfoPOD *chip;
@@ -675,9 +742,18 @@ struct Arch : BaseCtx
     mutable std::unordered_map<std::string, int> tile_by_name;
     mutable std::unordered_map<std::string, std::pair<int, int>> site_by_name;
 
-    dict<WireId, NetInfo *> wire_to_net;
-    dict<PipId, NetInfo *> pip_to_net;
-    dict<WireId, std::pair<int, int>> driving_pip_loc;
+    // Binding state, indexed by flat wire index (see getWireIndex). A wire is driven by at most one bound pip, so
+    // pip bindings are stored as the bound pip of their destination wire. These are only allocated by
+    // setupWireBindings, on the first binding or at the start of routing, so runs that never route don't pay for
+    // them; until then every wire is unbound
+    struct BoundWire
+    {
+        NetInfo *net = nullptr;
+        PipId pip;
+    };
+    std::vector<BoundWire> wire_binding;
+    // Tile of the last pip bound to drive each wire, or -1; used to estimate wire length in getPipDelay
+    std::vector<int32_t> driving_pip_tile;
     dict<WireId, NetInfo *> reserved_wires;
 
     struct LogicTileStatus
@@ -835,6 +911,20 @@ struct Arch : BaseCtx
     }
 
     void bindBel(BelId bel, CellInfo *cell, PlaceStrength strength)
+    {
+        bindBelConcurrent(bel, cell, strength);
+        refreshUiBel(bel);
+    }
+
+    void unbindBel(BelId bel)
+    {
+        unbindBelConcurrent(bel);
+        refreshUiBel(bel);
+    }
+
+    // As with wires, these only touch the state of the Bel's tile and the cell, so may be called from several
+    // threads at once for Bels in different tiles. Callers should call refreshUi() once they are done.
+    void bindBelConcurrent(BelId bel, CellInfo *cell, PlaceStrength strength)
     {
         NPNR_ASSERT(bel != BelId());
         NPNR_ASSERT(tileStatus[bel.tile].boundcells[bel.index] == nullptr);
@@ -846,7 +936,6 @@ struct Arch : BaseCtx
             tileStatus[bel.tile].sitevariant.at(site) = bd.site_variant;
         cell->bel = bel;
         cell->belStrength = strength;
-        refreshUiBel(bel);
 
         if (isLogicTile(bel))
             updateLogicBel(bel, cell);
@@ -854,14 +943,13 @@ struct Arch : BaseCtx
             updateBramBel(bel, cell);
     }
 
-    void unbindBel(BelId bel)
+    void unbindBelConcurrent(BelId bel)
     {
         NPNR_ASSERT(bel != BelId());
         NPNR_ASSERT(tileStatus[bel.tile].boundcells[bel.index] != nullptr);
         tileStatus[bel.tile].boundcells[bel.index]->bel = BelId();
         tileStatus[bel.tile].boundcells[bel.index]->belStrength = STRENGTH_NONE;
         tileStatus[bel.tile].boundcells[bel.index] = nullptr;
-        refreshUiBel(bel);
 
         if (isLogicTile(bel))
             updateLogicBel(bel, nullptr);
@@ -869,6 +957,34 @@ struct Arch : BaseCtx
             updateBramBel(bel, nullptr);
     }
 
+    // A checkpoint of every Bel binding, together with the tile status derived from them. Restoring one writes the
+    // binding state back directly, rather than unbinding and rebinding each cell, so is cheap enough for placers to
+    // keep the best solution seen so far.
+    struct PlacementSnapshot
+    {
+        std::vector<std::tuple<BelId, CellInfo *, PlaceStrength>> bindings;
+        std::vector<std::pair<int, LogicTileStatus>> logic_tiles;
+        std::vector<std::pair<int, BRAMTileStatus>> bram_tiles;
+        // Site variants of all tiles, concatenated in tile order
+        std::vector<int> sitevariant;
+    };
+
+    void savePlacement(PlacementSnapshot &snapshot) const;
+    // The cells of the design must not have changed since the snapshot was taken. Cells that were unplaced in the
+    // snapshot are left unplaced.
+    void restorePlacement(const PlacementSnapshot &snapshot);
+
+    // The super logic regions of a multi-die device, as ranges of rows in order of increasing y. Each die boundary is
+    // straddled by rows of Laguna tiles, with one super long line (SLL) between a TX register on one side and an RX
+    // register on the other. Devices without Laguna tiles have a single SLR.
+    struct SlrInfo
+    {
+        int y0, y1;
+        // Number of SLLs crossing to the next SLR, or 0 for the last
+        int sll_count;
+    };
+    std::vector<SlrInfo> getSlrs() const;
+
     bool usp_bel_hard_unavail(BelId bel) const
     {
         // if (chip_info->height > 600 && (bel.tile / chip_info->width) < 752) // constrain to SLR0
@@ -985,40 +1101,58 @@ struct Arch : BaseCtx
 
     uint32_t getWireChecksum(WireId wire) const { return wire.index; }
 
+    void setupWireBindings()
+    {
+        if (!wire_binding.empty())
+            return;
+        wire_binding.resize(getNumWires());
+        driving_pip_tile.resize(getNumWires(), -1);
+    }
+
     void bindWire(WireId wire, NetInfo *net, PlaceStrength strength)
     {
-        NPNR_ASSERT(wire != WireId());
-        NPNR_ASSERT(wire_to_net[wire] == nullptr);
-        wire_to_net[wire] = net;
-        net->wires[wire].pip = PipId();
-        net->wires[wire].strength = strength;
+        setupWireBindings();
+        bindWireConcurrent(wire, net, strength);
         refreshUiWire(wire);
     }
 
     void unbindWire(WireId wire)
     {
-        NPNR_ASSERT(wire != WireId());
-        NPNR_ASSERT(wire_to_net[wire] != nullptr);
-
-        auto &net_wires = wire_to_net[wire]->wires;
-        auto it = net_wires.find(wire);
-        NPNR_ASSERT(it != net_wires.end());
+        unbindWireConcurrent(wire);
+        refreshUiWire(wire);
+    }
 
-        auto pip = it->second.pip;
-        if (pip != PipId()) {
-            pip_to_net[pip] = nullptr;
-        }
+    // The *Concurrent binding functions only touch the binding state of the wires involved and the wire map of the
+    // net, so may be called from several threads at once for different nets using different wires. They do not
+    // refresh the UI, so callers should call refreshUi() once they are done. They also need setupWireBindings() to
+    // have been called first.
+    void bindWireConcurrent(WireId wire, NetInfo *net, PlaceStrength strength)
+    {
+        NPNR_ASSERT(wire != WireId());
+        NPNR_ASSERT(!wire_binding.empty());
+        auto &bw = wire_binding[getWireIndex(wire)];
+        NPNR_ASSERT(bw.net == nullptr);
+        bw.net = net;
+        bw.pip = PipId();
+        net->wires[wire].pip = PipId();
+        net->wires[wire].strength = strength;
+    }
 
-        net_wires.erase(it);
-        wire_to_net[wire] = nullptr;
-        refreshUiWire(wire);
+    void unbindWireConcurrent(WireId wire)
+    {
+        NPNR_ASSERT(wire != WireId());
+        NPNR_ASSERT(!wire_binding.empty());
+        auto &bw = wire_binding[getWireIndex(wire)];
+        NPNR_ASSERT(bw.net != nullptr);
+        NPNR_ASSERT(bw.net->wires.erase(wire) == 1);
+        bw.net = nullptr;
+        bw.pip = PipId();
     }
 
     bool checkWireAvail(WireId wire) const
     {
         NPNR_ASSERT(wire != WireId());
-        auto w2n = wire_to_net.find(wire);
-        return w2n == wire_to_net.end() || w2n->second == nullptr;
+        return wire_binding.empty() || wire_binding[getWireIndex(wire)].net == nullptr;
     }
 
     NetInfo *getReservedWireNet(WireId wire) const
@@ -1031,8 +1165,7 @@ struct Arch : BaseCtx
     NetInfo *getBoundWireNet(WireId wire) const
     {
         NPNR_ASSERT(wire != WireId());
-        auto w2n = wire_to_net.find(wire);
-        return w2n == wire_to_net.end() ? nullptr : w2n->second;
+        return wire_binding.empty() ? nullptr : wire_binding[getWireIndex(wire)].net;
     }
 
     WireId getConflictingWireWire(WireId wire) const { return wire; }
@@ -1040,8 +1173,7 @@ struct Arch : BaseCtx
     NetInfo *getConflictingWireNet(WireId wire) const
     {
         NPNR_ASSERT(wire != WireId());
-        auto w2n = wire_to_net.find(wire);
-        return w2n == wire_to_net.end() ? nullptr : w2n->second;
+        return wire_binding.empty() ? nullptr : wire_binding[getWireIndex(wire)].net;
     }
 
     DelayInfo getWireDelay(WireId wire) const
@@ -1097,6 +1229,30 @@ struct Arch : BaseCtx
         return range;
     }
 
+    // Dense wire indexing, in the same order as getWires(): nodes take [0, num_nodes), followed by the non-nodal
+    // wires of each tile. For each tile, a bitmap marks which of its tile-type wires are not part of a node; the
+    // index of a tile wire is then the running count of set bits before it.
+    std::vector<uint64_t> wire_index_bits;
+    // Dense index of the first set bit in each word of wire_index_bits, plus a final entry holding the total
+    std::vector<int32_t> wire_index_rank;
+    // First word of wire_index_bits for each tile, plus a final entry holding the total number of words
+    std::vector<int32_t> wire_index_tile_start;
+
+    void setup_wire_index();
+
+    int getNumWires() const { return wire_index_rank.back(); }
+
+    int getWireIndex(WireId wire) const
+    {
+        if (wire.tile == -1)
+            return wire.index;
+        int word = wire_index_tile_start[wire.tile] + (wire.index >> 6);
+        uint64_t mask = (uint64_t(1) << (wire.index & 63)) - 1;
+        return wire_index_rank[word] + int(std::bitset<64>(wire_index_bits[word] & mask).count());
+    }
+
+    WireId getWireByIndex(int index) const;
+
     // -------------------------------------------------
 
     mutable std::unordered_map<IdString, PipId> pip_by_name_cache;
@@ -1105,33 +1261,40 @@ struct Arch : BaseCtx
 
     void bindPip(PipId pip, NetInfo *net, PlaceStrength strength)
     {
-        NPNR_ASSERT(pip != PipId());
-        NPNR_ASSERT(pip_to_net[pip] == nullptr);
+        setupWireBindings();
+        bindPipConcurrent(pip, net, strength);
+        refreshUiPip(pip);
+        refreshUiWire(getPipDstWire(pip));
+    }
 
+    void bindPipConcurrent(PipId pip, NetInfo *net, PlaceStrength strength)
+    {
+        NPNR_ASSERT(pip != PipId());
         WireId dst = canonicalWireId(chip_info, pip.tile, locInfo(pip).pip_data[pip.index].dst_index);
-        NPNR_ASSERT(wire_to_net[dst] == nullptr || wire_to_net[dst] == net);
+        int dst_idx = getWireIndex(dst);
+        NPNR_ASSERT(!wire_binding.empty());
+        auto &bw = wire_binding[dst_idx];
+        NPNR_ASSERT(bw.pip != pip);
+        NPNR_ASSERT(bw.net == nullptr || (bw.net == net && bw.pip == PipId()));
 
-        pip_to_net[pip] = net;
-        driving_pip_loc[dst] = std::make_pair(pip.tile % chip_info->width, pip.tile / chip_info->width);
+        bw.net = net;
+        bw.pip = pip;
+        driving_pip_tile[dst_idx] = pip.tile;
 
-        wire_to_net[dst] = net;
         net->wires[dst].pip = pip;
         net->wires[dst].strength = strength;
-        refreshUiPip(pip);
-        refreshUiWire(dst);
     }
 
     void unbindPip(PipId pip)
     {
         NPNR_ASSERT(pip != PipId());
-        NPNR_ASSERT(pip_to_net[pip] != nullptr);
-
         WireId dst = canonicalWireId(chip_info, pip.tile, locInfo(pip).pip_data[pip.index].dst_index);
-        NPNR_ASSERT(wire_to_net[dst] != nullptr);
-        wire_to_net[dst] = nullptr;
-        pip_to_net[pip]->wires.erase(dst);
-
-        pip_to_net[pip] = nullptr;
+        NPNR_ASSERT(!wire_binding.empty());
+        auto &bw = wire_binding[getWireIndex(dst)];
+        NPNR_ASSERT(bw.pip == pip && bw.net != nullptr);
+        bw.net->wires.erase(dst);
+        bw.net = nullptr;
+        bw.pip = PipId();
         refreshUiPip(pip);
         refreshUiWire(dst);
     }
@@ -1210,14 +1373,16 @@ struct Arch : BaseCtx
         NPNR_ASSERT(pip != PipId());
         if (usp_pip_hard_unavail(pip))
             return false;
-        return pip_to_net.find(pip) == pip_to_net.end() || pip_to_net.at(pip) == nullptr;
+        return getBoundPipNet(pip) == nullptr;
     }
 
     NetInfo *getBoundPipNet(PipId pip) const
     {
         NPNR_ASSERT(pip != PipId());
-        auto p2n = pip_to_net.find(pip);
-        return p2n == pip_to_net.end() ? nullptr : p2n->second;
+        if (wire_binding.empty())
+            return nullptr;
+        auto &bw = wire_binding[getWireIndex(getPipDstWire(pip))];
+        return bw.pip == pip ? bw.net : nullptr;
     }
 
     WireId getConflictingPipWire(PipId pip) const
@@ -1231,9 +1396,7 @@ struct Arch : BaseCtx
     {
         if (usp_pip_hard_unavail(pip))
             return nullptr;
-        NPNR_ASSERT(pip != PipId());
-        auto p2n = pip_to_net.find(pip);
-        return p2n == pip_to_net.end() ? nullptr : p2n->second;
+        return getBoundPipNet(pip);
     }
 
     AllPipRange getPips() const
@@ -1365,7 +1528,11 @@ struct Arch : BaseCtx
             return locInfo(wire).wire_data[wire.index].intent;
     }
 
-    DelayInfo getPipDelay(PipId pip) const
+    DelayInfo getPipDelay(PipId pip) const { return pipDelay(pip, true); }
+
+    // With bound_length false, the source wire is taken to be one tile long whatever is bound to drive it, so that
+    // the delay only depends on the chipdb
+    DelayInfo pipDelay(PipId pip, bool bound_length) const
     {
         DelayInfo delay;
         NPNR_ASSERT(pip != PipId());
@@ -1389,11 +1556,12 @@ struct Arch : BaseCtx
                 auto &pip_data = locInfo(pip).pip_data[pip.index];
                 auto &pip_timing = chip_info->timing_data->pip_timing_classes[pip_data.timing_class];
                 int src_len = 1;
-                auto found_srcloc = driving_pip_loc.find(getPipSrcWire(pip));
-                if (found_srcloc != driving_pip_loc.end()) {
-                    src_len =
-                            std::max(1, std::abs(found_srcloc->second.first - (pip.tile % chip_info->width)) +
-                                                std::abs(found_srcloc->second.second - (pip.tile / chip_info->width)));
+                int src_drv_tile = (bound_length && !driving_pip_tile.empty())
+                                           ? driving_pip_tile[getWireIndex(getPipSrcWire(pip))]
+                                           : -1;
+                if (src_drv_tile != -1) {
+                    src_len = std::max(1, std::abs(src_drv_tile % chip_info->width - pip.tile % chip_info->width) +
+                                                  std::abs(src_drv_tile / chip_info->width - pip.tile / chip_info->width));
                 }
                 auto &src_timing =
                         chip_info->timing_data
@@ -1491,6 +1659,20 @@ struct Arch : BaseCtx
     uint32_t getDelayChecksum(delay_t v) const { return v; }
     bool getBudgetOverride(const NetInfo *net_info, const PortRef &sink, delay_t &budget) const;
 
+    // Routing lookahead (lookahead.cc), loaded or built at the start of routing
+    RouteLookahead lookahead;
+    void setupLookahead();
+    uint64_t chipdbHash() const;
+    bool loadLookahead(const std::string &filename, uint64_t hash);
+    void buildLookahead(uint64_t hash);
+    void writeLookahead(const std::string &filename) const;
+    void indexLookahead(const char *base, size_t size);
+
+    // Placement delay model (lookahead.cc), derived from the routing lookahead at the start of placement. Without
+    // it, predictDelay falls back to a simple formula
+    PlaceDelayTable place_delays;
+    void setupPlaceDelays();
+
     // -------------------------------------------------
 
     bool pack();
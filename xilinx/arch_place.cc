@@ -635,6 +635,74 @@ bool Arch::isValidBelForCell(CellInfo *cell, BelId bel) const
     return true;
 }
 
+void Arch::savePlacement(PlacementSnapshot &snapshot) const
+{
+    snapshot.bindings.clear();
+    snapshot.logic_tiles.clear();
+    snapshot.bram_tiles.clear();
+    snapshot.sitevariant.clear();
+    for (auto &cell : cells) {
+        CellInfo *ci = cell.second.get();
+        if (ci->bel != BelId())
+            snapshot.bindings.emplace_back(ci->bel, ci, ci->belStrength);
+    }
+    for (int i = 0; i < int(tileStatus.size()); i++) {
+        auto &ts = tileStatus[i];
+        if (ts.lts != nullptr)
+            snapshot.logic_tiles.emplace_back(i, *ts.lts);
+        if (ts.bts != nullptr)
+            snapshot.bram_tiles.emplace_back(i, *ts.bts);
+        snapshot.sitevariant.insert(snapshot.sitevariant.end(), ts.sitevariant.begin(), ts.sitevariant.end());
+    }
+}
+
+void Arch::restorePlacement(const PlacementSnapshot &snapshot)
+{
+    for (auto &cell : cells) {
+        CellInfo *ci = cell.second.get();
+        if (ci->bel == BelId())
+            continue;
+        tileStatus[ci->bel.tile].boundcells[ci->bel.index] = nullptr;
+        ci->bel = BelId();
+        ci->belStrength = STRENGTH_NONE;
+    }
+    // Tiles without saved status had nothing bound when the snapshot was taken, so are reset to their initial state
+    int sv = 0;
+    for (auto &ts : tileStatus) {
+        if (ts.lts != nullptr)
+            *ts.lts = LogicTileStatus();
+        if (ts.bts != nullptr)
+            *ts.bts = BRAMTileStatus();
+        NPNR_ASSERT(sv + ts.sitevariant.size() <= snapshot.sitevariant.size());
+        std::copy(snapshot.sitevariant.begin() + sv, snapshot.sitevariant.begin() + sv + ts.sitevariant.size(),
+                  ts.sitevariant.begin());
+        sv += int(ts.sitevariant.size());
+    }
+    for (auto &lt : snapshot.logic_tiles) {
+        auto &ts = tileStatus[lt.first];
+        if (ts.lts == nullptr)
+            ts.lts = new LogicTileStatus();
+        *ts.lts = lt.second;
+    }
+    for (auto &bt : snapshot.bram_tiles) {
+        auto &ts = tileStatus[bt.first];
+        if (ts.bts == nullptr)
+            ts.bts = new BRAMTileStatus();
+        *ts.bts = bt.second;
+    }
+    for (auto &b : snapshot.bindings) {
+        BelId bel;
+        CellInfo *ci;
+        PlaceStrength strength;
+        std::tie(bel, ci, strength) = b;
+        NPNR_ASSERT(tileStatus[bel.tile].boundcells[bel.index] == nullptr);
+        tileStatus[bel.tile].boundcells[bel.index] = ci;
+        ci->bel = bel;
+        ci->belStrength = strength;
+    }
+    refreshUi();
+}
+
 void Arch::fixupPlacement()
 {
     log_info("Running post-placement legalisation...\n");
@@ -0,0 +1,279 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+// Placement benchmark: generates synthetic netlists of LUTs and flipflops, packs and places each with HeAP and SA,
+// and writes one JSON report holding the placer performance report (see PlacePerfReport) of every run.
+//
+// nextpnr-xilinx-bench --chipdb <file> [--luts 1000,10000] [--placers heap,sa] [--seed N] [--threads N]
+//                      [--report bench.json] [--write-netlists <prefix>] [--verbose]
+//
+// With --placers '' the netlists are only generated, which needs no chipdb.
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include "json_frontend.h"
+#include "log.h"
+#include "nextpnr.h"
+#include "timing.h"
+
+USING_NEXTPNR_NAMESPACE
+
+namespace {
+
+struct BenchOptions
+{
+    std::string chipdb;
+    std::vector<int> luts{1000, 10000};
+    std::vector<std::string> placers{"heap", "sa"};
+    uint64_t seed = 1;
+    int threads = 0;
+    std::string report = "bench.json";
+    // If set, the netlists are written to <prefix><luts>.json, for example to run the full flow on them
+    std::string netlist_prefix;
+    bool verbose = false;
+};
+
+std::vector<std::string> split_list(const std::string &list)
+{
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+}
+
+// Write a yosys-style JSON netlist of a clocked random logic network. Each LUT6 takes its inputs mostly from the
+// recently created signals, so the netlist has the locality of real logic, with a few long connections; half of
+// the LUTs drive a flipflop. Inputs and outputs are unconstrained IOs, placed by the packer.
+std::string make_netlist(int num_luts, uint64_t seed)
+{
+    DeterministicRNG rng;
+    rng.rngseed(seed);
+    const int num_inputs = 16, num_outputs = 16;
+    int next_bit = 2;
+    std::vector<int> signals;
+    std::ostringstream ports, cells;
+    bool first_cell = true;
+
+    auto cell = [&](const std::string &name, const std::string &type, const std::string &params,
+                    const std::vector<std::pair<std::string, std::string>> &conns, const std::string &output) {
+        cells << (first_cell ? "" : ",\n") << "        \"" << name << "\": {\n";
+        cells << "          \"hide_name\": 0,\n          \"type\": \"" << type << "\",\n";
+        cells << "          \"parameters\": {" << params << "},\n          \"attributes\": {},\n";
+        cells << "          \"port_directions\": {";
+        for (auto &c : conns)
+            cells << "\"" << c.first << "\": \"" << (c.first == output ? "output" : "input") << "\", ";
+        cells.seekp(-2, std::ios_base::cur);
+        cells << "},\n          \"connections\": {";
+        for (auto &c : conns)
+            cells << "\"" << c.first << "\": [" << c.second << "], ";
+        cells.seekp(-2, std::ios_base::cur);
+        cells << "}\n        }";
+        first_cell = false;
+    };
+    auto bit = [](int b) { return std::to_string(b); };
+
+    // Clock: pad, IBUF and BUFG
+    int clk_pad = next_bit++, clk_ibuf = next_bit++, clk = next_bit++;
+    ports << "        \"clk\": {\"direction\": \"input\", \"bits\": [" << clk_pad << "]}";
+    cell("clk_ibuf", "IBUF", "", {{"I", bit(clk_pad)}, {"O", bit(clk_ibuf)}}, "O");
+    cell("clk_bufg", "BUFG", "", {{"I", bit(clk_ibuf)}, {"O", bit(clk)}}, "O");
+
+    for (int i = 0; i < num_inputs; i++) {
+        int pad = next_bit++, sig = next_bit++;
+        ports << ",\n        \"in" << i << "\": {\"direction\": \"input\", \"bits\": [" << pad << "]}";
+        cell("in_ibuf" + std::to_string(i), "IBUF", "", {{"I", bit(pad)}, {"O", bit(sig)}}, "O");
+        signals.push_back(sig);
+    }
+
+    for (int i = 0; i < num_luts; i++) {
+        std::vector<std::pair<std::string, std::string>> conns;
+        for (int j = 0; j < 6; j++) {
+            // One input in eight comes from anywhere in the design, the rest from the last 64 signals
+            int n = int(signals.size());
+            int src = (rng.rng(8) == 0) ? rng.rng(n) : n - 1 - rng.rng(std::min(n, 64));
+            conns.emplace_back("I" + std::to_string(j), bit(signals.at(src)));
+        }
+        int out = next_bit++;
+        conns.emplace_back("O", bit(out));
+        std::string init;
+        for (int j = 0; j < 64; j++)
+            init += rng.rng(2) ? '1' : '0';
+        cell("lut" + std::to_string(i), "LUT6", "\"INIT\": \"" + init + "\"", conns, "O");
+        if (i % 2 == 0) {
+            int q = next_bit++;
+            cell("ff" + std::to_string(i), "FDRE", "\"INIT\": \"0\"",
+                 {{"C", bit(clk)}, {"CE", "\"1\""}, {"R", "\"0\""}, {"D", bit(out)}, {"Q", bit(q)}}, "Q");
+            signals.push_back(q);
+        } else {
+            signals.push_back(out);
+        }
+    }
+
+    for (int i = 0; i < num_outputs; i++) {
+        int pad = next_bit++;
+        ports << ",\n        \"out" << i << "\": {\"direction\": \"output\", \"bits\": [" << pad << "]}";
+        cell("out_obuf" + std::to_string(i), "OBUF", "",
+             {{"I", bit(signals.at(signals.size() - 1 - i))}, {"O", bit(pad)}}, "O");
+    }
+
+    std::ostringstream json;
+    json << "{\n  \"creator\": \"nextpnr-xilinx-bench\",\n  \"modules\": {\n    \"top\": {\n";
+    json << "      \"attributes\": {\"top\": \"00000000000000000000000000000001\"},\n";
+    json << "      \"ports\": {\n" << ports.str() << "\n      },\n";
+    json << "      \"cells\": {\n" << cells.str() << "\n      },\n";
+    json << "      \"netnames\": {}\n    }\n  }\n}\n";
+    return json.str();
+}
+
+std::string read_file(const std::string &filename)
+{
+    std::ifstream in(filename);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    std::string s = ss.str();
+    while (!s.empty() && (s.back() == '\n' || s.back() == ' '))
+        s.pop_back();
+    return s;
+}
+
+// Pack and place one netlist, returning a JSON object for the run; empty if it failed
+std::string run_placer(const BenchOptions &opts, const std::string &netlist, int luts, const std::string &placer)
+{
+    try {
+        ArchArgs args;
+        args.chipdb = opts.chipdb;
+        std::unique_ptr<Context> ctx(new Context(args));
+        std::string perf_file = opts.report + ".tmp";
+        ctx->rngseed(opts.seed);
+        ctx->settings[ctx->id("seed")] = int(opts.seed);
+        ctx->settings[ctx->id("target_freq")] = std::to_string(12e6);
+        ctx->settings[ctx->id("timing_driven")] = true;
+        ctx->settings[ctx->id("slack_redist_iter")] = 0;
+        ctx->settings[ctx->id("auto_freq")] = false;
+        ctx->settings[ctx->id("placer")] = placer;
+        ctx->settings[ctx->id("placer/perfReport")] = perf_file;
+        if (opts.threads > 0)
+            ctx->settings[ctx->id("threads")] = opts.threads;
+
+        std::istringstream in(netlist);
+        if (!parse_json(in, "<synthetic>", ctx.get()))
+            return "";
+        if (!ctx->pack())
+            return "";
+        assign_budget(ctx.get());
+        auto start = std::chrono::high_resolution_clock::now();
+        if (!ctx->place())
+            return "";
+        auto end = std::chrono::high_resolution_clock::now();
+        std::ostringstream run;
+        run << "    {\"placer\": \"" << placer << "\", \"luts\": " << luts << ", \"place_time_s\": "
+            << std::chrono::duration<double>(end - start).count() << ",\n     \"report\": " << read_file(perf_file)
+            << "}";
+        std::remove(perf_file.c_str());
+        return run.str();
+    } catch (const log_execution_error_exception &) {
+        return "";
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    BenchOptions opts;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << "missing value for " << arg << std::endl;
+                exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--chipdb")
+            opts.chipdb = value();
+        else if (arg == "--luts") {
+            opts.luts.clear();
+            for (auto &n : split_list(value()))
+                opts.luts.push_back(std::stoi(n));
+        } else if (arg == "--placers")
+            opts.placers = split_list(value());
+        else if (arg == "--seed")
+            opts.seed = std::stoull(value());
+        else if (arg == "--threads")
+            opts.threads = std::stoi(value());
+        else if (arg == "--report")
+            opts.report = value();
+        else if (arg == "--write-netlists")
+            opts.netlist_prefix = value();
+        else if (arg == "--verbose")
+            opts.verbose = true;
+        else {
+            std::cerr << "usage: " << argv[0]
+                      << " --chipdb <file> [--luts 1000,10000] [--placers heap,sa] [--seed N] [--threads N]"
+                         " [--report bench.json] [--write-netlists <prefix>] [--verbose]"
+                      << std::endl;
+            return 1;
+        }
+    }
+    if (opts.chipdb.empty() && !opts.placers.empty()) {
+        std::cerr << "chip database binary must be provided with --chipdb" << std::endl;
+        return 1;
+    }
+    log_streams.clear();
+    log_streams.push_back(std::make_pair(&std::cerr, opts.verbose ? LogLevel::LOG_MSG : LogLevel::WARNING_MSG));
+
+    std::vector<std::string> runs;
+    bool failed = false;
+    for (int luts : opts.luts) {
+        std::string netlist = make_netlist(luts, opts.seed);
+        if (!opts.netlist_prefix.empty()) {
+            std::ofstream nl(opts.netlist_prefix + std::to_string(luts) + ".json");
+            nl << netlist;
+        }
+        for (auto &placer : opts.placers) {
+            std::cerr << "Placing " << luts << " LUTs with " << placer << "..." << std::endl;
+            std::string run = run_placer(opts, netlist, luts, placer);
+            if (run.empty()) {
+                std::cerr << "Placing " << luts << " LUTs with " << placer << " failed" << std::endl;
+                failed = true;
+                continue;
+            }
+            runs.push_back(run);
+        }
+    }
+
+    std::ofstream out(opts.report);
+    if (!out) {
+        std::cerr << "failed to open report '" << opts.report << "' for writing" << std::endl;
+        return 1;
+    }
+    out << "{\n  \"seed\": " << opts.seed << ",\n  \"runs\": [\n";
+    for (size_t i = 0; i < runs.size(); i++)
+        out << runs.at(i) << (i + 1 < runs.size() ? ",\n" : "\n");
+    out << "  ]\n}\n";
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,464 @@
+/*
+ *  nextpnr -- Next Generation Place and Route
+ *
+ *  Copyright (C) 2026  agent <agent@local>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+/*
+ * Routing lookahead for estimateDelay
+ *
+ * For each class of wire, keyed by the tile type of its anchor tile (the first tile of a node) and its intent, a few
+ * wires near the middle of the device are picked and a Dijkstra search run from each of them over the real routing
+ * graph. The lowest delay at which a site wire is reached at each (dx, dy) offset inside a window is recorded, and
+ * offsets that were never reached are filled in from their neighbours.
+ *
+ * As this depends only on the chipdb, the table is written next to the chipdb and keyed by a fingerprint of it (see
+ * chipdbHash), so only the first run on a device pays for building it; later runs mmap the file.
+ *
+ * The placer's predictDelay uses a smaller table derived from this one, keyed by the tile type of the source Bel
+ * rather than by wire, so that placement timing costs follow the routed delays of the device.
+ */
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <queue>
+#include "log.h"
+#include "nextpnr.h"
+#include "task_pool.h"
+#include "util.h"
+
+NEXTPNR_NAMESPACE_BEGIN
+
+namespace {
+const uint32_t lookahead_magic = 0x414c504e; // "NPLA"
+const uint32_t lookahead_version = 2;
+
+// Size of the table window, in tiles either side of the source
+const int lookahead_max_dx = 30, lookahead_max_dy = 30;
+// Searches may leave the window by this many tiles, as routes sometimes detour
+const int lookahead_margin = 8;
+// Sampled sources per class, and limit on wires visited by each search
+const int lookahead_samples = 3;
+const int lookahead_max_visit = 250000;
+} // namespace
+
+uint64_t Arch::chipdbHash() const
+{
+    // Hashing every byte would page the whole multi-gigabyte database in from disk just to check the cache, so this
+    // is a fingerprint rather than a checksum: FNV-1a over the file size and modification time, the chipdb header
+    // fields, and a sample of 64K words spread evenly over the file. The modification time catches a database that
+    // is regenerated at the same size with changes the sample misses; the cost is that copying a chipdb without
+    // preserving its time rebuilds the lookahead once.
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    auto add = [&](uint64_t w) {
+        hash ^= w;
+        hash *= 0x100000001b3ULL;
+    };
+    auto add_str = [&](const char *str) {
+        for (; *str; str++)
+            add(uint8_t(*str));
+    };
+    size_t size = blob_file.size();
+    add(size);
+    try {
+        add(uint64_t(boost::filesystem::last_write_time(args.chipdb)));
+    } catch (const boost::filesystem::filesystem_error &) {
+        add(0);
+    }
+    add_str(chip_info->name.get());
+    add_str(chip_info->generator.get());
+    for (int32_t field : {chip_info->version, chip_info->width, chip_info->height, chip_info->num_tiles,
+                          chip_info->num_tiletypes, chip_info->num_nodes, chip_info->num_speed_grades})
+        add(uint32_t(field));
+    const char *data = blob_file.data();
+    size_t num_words = size / sizeof(uint64_t);
+    size_t stride = std::max<size_t>(1, num_words / 65536);
+    for (size_t i = 0; i < num_words; i += stride) {
+        uint64_t w;
+        std::memcpy(&w, data + i * sizeof(uint64_t), sizeof(uint64_t));
+        add(w);
+    }
+    return hash;
+}
+
+void Arch::indexLookahead(const char *base, size_t size)
+{
+    auto &la = lookahead;
+    la.header = reinterpret_cast<const LookaheadHeaderPOD *>(base);
+    la.intents = reinterpret_cast<const int32_t *>(base + sizeof(LookaheadHeaderPOD));
+    la.class_map = la.intents + la.header->num_intents;
+    la.delays = la.class_map + la.header->num_tile_types * la.header->num_intents;
+    NPNR_ASSERT(reinterpret_cast<const char *>(la.delays + la.header->num_classes * (2 * la.header->max_dx + 1) *
+                                                                 (2 * la.header->max_dy + 1)) == base + size);
+    la.intent_idx.clear();
+    for (int i = 0; i < la.header->num_intents; i++) {
+        int intent = la.intents[i];
+        if (intent >= int(la.intent_idx.size()))
+            la.intent_idx.resize(intent + 1, -1);
+        la.intent_idx[intent] = i;
+    }
+}
+
+bool Arch::loadLookahead(const std::string &filename, uint64_t hash)
+{
+    auto &la = lookahead;
+    try {
+        la.file.open(filename);
+    } catch (...) {
+        return false;
+    }
+    if (!la.file.is_open())
+        return false;
+    size_t size = la.file.size();
+    auto hdr = reinterpret_cast<const LookaheadHeaderPOD *>(la.file.data());
+    bool valid = size >= sizeof(LookaheadHeaderPOD) && hdr->magic == lookahead_magic &&
+                 hdr->version == lookahead_version && hdr->chipdb_hash == hash &&
+                 hdr->num_tile_types == chip_info->num_tiletypes;
+    if (valid) {
+        size_t expected = sizeof(LookaheadHeaderPOD) +
+                          sizeof(int32_t) * (size_t(hdr->num_intents) * (1 + hdr->num_tile_types) +
+                                             size_t(hdr->num_classes) * (2 * hdr->max_dx + 1) * (2 * hdr->max_dy + 1));
+        valid = (size == expected);
+    }
+    if (!valid) {
+        log_info("Routing lookahead '%s' does not match this chipdb, rebuilding.\n", filename.c_str());
+        la.file.close();
+        return false;
+    }
+    indexLookahead(la.file.data(), size);
+    return true;
+}
+
+void Arch::buildLookahead(uint64_t hash)
+{
+    auto rstart = std::chrono::high_resolution_clock::now();
+    const int width = 2 * lookahead_max_dx + 1, height = 2 * lookahead_max_dy + 1;
+
+    auto anchor_tile = [&](WireId wire) {
+        return wire.tile == -1 ? chip_info->nodes[wire.index].tile_wires[0].tile : wire.tile;
+    };
+
+    // Pick sample sources for each class, preferring wires in the middle half of the device to avoid edge effects
+    struct ClassSamples
+    {
+        std::vector<WireId> central, other;
+        int n_central = 0, n_other = 0;
+    };
+    std::map<std::pair<int, int>, ClassSamples> samples;
+    DeterministicRNG rng;
+    rng.rngseed(1);
+    auto reservoir_add = [&](std::vector<WireId> &vec, int &count, WireId wire) {
+        ++count;
+        if (int(vec.size()) < lookahead_samples) {
+            vec.push_back(wire);
+        } else {
+            int j = rng.rng(count);
+            if (j < lookahead_samples)
+                vec.at(j) = wire;
+        }
+    };
+    for (auto wire : getWires()) {
+        int intent = wireIntent(wire);
+        if (intent == ID_PSEUDO_GND || intent == ID_PSEUDO_VCC)
+            continue;
+        auto dh = getPipsDownhill(wire);
+        if (!(dh.begin() != dh.end()))
+            continue;
+        int tile = anchor_tile(wire);
+        int x = tile % chip_info->width, y = tile / chip_info->width;
+        auto &cs = samples[std::make_pair(chip_info->tile_insts[tile].type, intent)];
+        if (x >= chip_info->width / 4 && x < (3 * chip_info->width) / 4 && y >= chip_info->height / 4 &&
+            y < (3 * chip_info->height) / 4)
+            reservoir_add(cs.central, cs.n_central, wire);
+        else
+            reservoir_add(cs.other, cs.n_other, wire);
+    }
+
+    // Dense intent indices and classes, in a deterministic order
+    std::map<int, int> intent_to_idx;
+    for (auto &s : samples)
+        intent_to_idx[s.first.second] = 0;
+    int num_intents = 0;
+    for (auto &i : intent_to_idx)
+        i.second = num_intents++;
+    int num_classes = int(samples.size());
+
+    auto &buf = lookahead.built;
+    buf.clear();
+    buf.resize(sizeof(LookaheadHeaderPOD) / sizeof(int32_t));
+    LookaheadHeaderPOD hdr;
+    hdr.magic = lookahead_magic;
+    hdr.version = lookahead_version;
+    hdr.chipdb_hash = hash;
+    hdr.num_tile_types = chip_info->num_tiletypes;
+    hdr.num_intents = num_intents;
+    hdr.num_classes = num_classes;
+    hdr.max_dx = lookahead_max_dx;
+    hdr.max_dy = lookahead_max_dy;
+    hdr.padding = 0;
+    memcpy(buf.data(), &hdr, sizeof(hdr));
+    for (auto &i : intent_to_idx)
+        buf.push_back(i.first);
+    size_t class_map_start = buf.size();
+    buf.resize(class_map_start + size_t(chip_info->num_tiletypes) * num_intents, -1);
+    size_t delays_start = buf.size();
+    buf.resize(delays_start + size_t(num_classes) * width * height, -1);
+
+    std::vector<std::pair<int, WireId>> sources;
+    int cls = 0;
+    for (auto &s : samples) {
+        buf.at(class_map_start + s.first.first * num_intents + intent_to_idx.at(s.first.second)) = cls;
+        for (auto src : s.second.central.empty() ? s.second.other : s.second.central)
+            sources.emplace_back(cls, src);
+        ++cls;
+    }
+
+    log_info("Building routing lookahead for %d wire classes...\n", num_classes);
+
+    // Search from each source. Results are merged by taking the minimum, so are independent of thread count
+    std::mutex merge_mutex;
+    auto search = [&](int src_cls, WireId src) {
+        int src_tile = anchor_tile(src);
+        int src_x = src_tile % chip_info->width, src_y = src_tile / chip_info->width;
+        std::vector<int32_t> result(width * height, -1);
+        std::unordered_map<int, delay_t> visited;
+        typedef std::pair<delay_t, WireId> QueuedWire;
+        auto cmp = [](const QueuedWire &a, const QueuedWire &b) { return a.first > b.first; };
+        std::priority_queue<QueuedWire, std::vector<QueuedWire>, decltype(cmp)> queue(cmp);
+        queue.emplace(0, src);
+        visited[getWireIndex(src)] = 0;
+        int visit_count = 0;
+        while (!queue.empty() && visit_count < lookahead_max_visit) {
+            QueuedWire curr = queue.top();
+            queue.pop();
+            if (visited.at(getWireIndex(curr.second)) < curr.first)
+                continue;
+            ++visit_count;
+            WireId wire = curr.second;
+            if (wire.tile != -1 && wireInfo(wire).site != -1) {
+                auto &site = chip_info->tile_insts[wire.tile].site_insts[wireInfo(wire).site];
+                int x = site.inter_x != -1 ? site.inter_x : (wire.tile % chip_info->width);
+                int y = site.inter_x != -1 ? site.inter_y : (wire.tile / chip_info->width);
+                int dx = x - src_x, dy = y - src_y;
+                if (std::abs(dx) <= lookahead_max_dx && std::abs(dy) <= lookahead_max_dy) {
+                    int32_t &r = result.at((dy + lookahead_max_dy) * width + (dx + lookahead_max_dx));
+                    if (r == -1 || curr.first < r)
+                        r = curr.first;
+                }
+            }
+            for (auto pip : getPipsDownhill(wire)) {
+                if (blacklist_pips.count(locInfo(pip).type) && blacklist_pips.at(locInfo(pip).type).count(pip.index))
+                    continue;
+                WireId next = getPipDstWire(pip);
+                int next_intent = wireIntent(next);
+                if (next_intent == ID_PSEUDO_GND || next_intent == ID_PSEUDO_VCC)
+                    continue;
+                int next_tile = anchor_tile(next);
+                if (std::abs(next_tile % chip_info->width - src_x) > lookahead_max_dx + lookahead_margin ||
+                    std::abs(next_tile / chip_info->width - src_y) > lookahead_max_dy + lookahead_margin)
+                    continue;
+                // The table is cached against the chipdb alone, so mustn't depend on any routing already bound
+                delay_t next_delay = curr.first + pipDelay(pip, false).maxDelay() + getWireDelay(next).maxDelay();
+                auto fnd = visited.find(getWireIndex(next));
+                if (fnd != visited.end() && fnd->second <= next_delay)
+                    continue;
+                visited[getWireIndex(next)] = next_delay;
+                queue.emplace(next_delay, next);
+            }
+        }
+        std::lock_guard<std::mutex> lk(merge_mutex);
+        for (int i = 0; i < width * height; i++) {
+            int32_t &d = buf.at(delays_start + size_t(src_cls) * width * height + i);
+            if (result.at(i) != -1 && (d == -1 || result.at(i) < d))
+                d = result.at(i);
+        }
+    };
+
+    TaskPool pool(get_thread_count(getCtx()));
+    for (auto &s : sources) {
+        int src_cls = s.first;
+        WireId src = s.second;
+        pool.add([&search, src_cls, src]() { search(src_cls, src); });
+    }
+    pool.run();
+
+    // Fill in offsets that were never reached from their neighbours, so that the table has no holes for classes with
+    // any data at all
+    delay_t step_x = xc7 ? 45 : 30, step_y = xc7 ? 90 : 60;
+    for (int c = 0; c < num_classes; c++) {
+        int32_t *d = buf.data() + delays_start + size_t(c) * width * height;
+        std::vector<bool> reached(width * height);
+        bool any = false;
+        for (int i = 0; i < width * height; i++) {
+            reached.at(i) = (d[i] != -1);
+            any |= reached.at(i);
+        }
+        if (!any)
+            continue;
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (int y = 0; y < height; y++)
+                for (int x = 0; x < width; x++) {
+                    if (reached.at(y * width + x))
+                        continue;
+                    int32_t &v = d[y * width + x];
+                    auto relax = [&](int nx, int ny, delay_t step) {
+                        if (nx < 0 || nx >= width || ny < 0 || ny >= height)
+                            return;
+                        int32_t nv = d[ny * width + nx];
+                        if (nv != -1 && (v == -1 || nv + step < v)) {
+                            v = nv + step;
+                            changed = true;
+                        }
+                    };
+                    relax(x - 1, y, step_x);
+                    relax(x + 1, y, step_x);
+                    relax(x, y - 1, step_y);
+                    relax(x, y + 1, step_y);
+                }
+        }
+    }
+
+    indexLookahead(reinterpret_cast<const char *>(buf.data()), buf.size() * sizeof(int32_t));
+    auto rend = std::chrono::high_resolution_clock::now();
+    log_info("Built routing lookahead from %d searches in %.02fs.\n", int(sources.size()),
+             std::chrono::duration<float>(rend - rstart).count());
+}
+
+void Arch::writeLookahead(const std::string &filename) const
+{
+    std::string tmp_filename = filename + ".tmp";
+    {
+        std::ofstream out(tmp_filename, std::ios::binary);
+        if (out)
+            out.write(reinterpret_cast<const char *>(lookahead.built.data()),
+                      lookahead.built.size() * sizeof(int32_t));
+        if (!out) {
+            log_warning("Failed to write routing lookahead to '%s'.\n", tmp_filename.c_str());
+            return;
+        }
+    }
+    // Write then rename, so that concurrent runs never see a partial file
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        log_warning("Failed to write routing lookahead to '%s'.\n", filename.c_str());
+        std::remove(tmp_filename.c_str());
+    }
+}
+
+void Arch::setupPlaceDelays()
+{
+    if (place_delays.ready())
+        return;
+    setupLookahead();
+    if (!lookahead.ready())
+        return;
+    auto rstart = std::chrono::high_resolution_clock::now();
+    auto &pd = place_delays;
+    pd.max_dx = lookahead.header->max_dx;
+    pd.max_dy = lookahead.header->max_dy;
+    // As estimateDelay, outside the lookahead window
+    pd.outside_x = xc7 ? 15 : 10;
+    pd.outside_y = xc7 ? 30 : 20;
+    const int width = 2 * pd.max_dx + 1, height = 2 * pd.max_dy + 1;
+
+    // Use the instance of each tile type nearest the middle of the device, to avoid edge effects
+    std::vector<int> sample_tile(chip_info->num_tiletypes, -1), sample_dist(chip_info->num_tiletypes);
+    for (int tile = 0; tile < chip_info->num_tiles; tile++) {
+        int type = chip_info->tile_insts[tile].type;
+        if (chip_info->tile_types[type].num_bels == 0)
+            continue;
+        int dist = std::abs(tile % chip_info->width - chip_info->width / 2) +
+                   std::abs(tile / chip_info->width - chip_info->height / 2);
+        if (sample_tile.at(type) == -1 || dist < sample_dist.at(type)) {
+            sample_tile.at(type) = tile;
+            sample_dist.at(type) = dist;
+        }
+    }
+
+    // The delay at each offset from a tile is the lowest from any Bel output in it, looked up relative to the anchor
+    // tile of the output's wire
+    pd.tile_type_class.assign(chip_info->num_tiletypes, -1);
+    pd.delays.clear();
+    int num_classes = 0;
+    std::vector<delay_t> table(width * height);
+    for (int type = 0; type < chip_info->num_tiletypes; type++) {
+        int tile = sample_tile.at(type);
+        if (tile == -1)
+            continue;
+        int tile_x = tile % chip_info->width, tile_y = tile / chip_info->width;
+        std::fill(table.begin(), table.end(), -1);
+        bool any = false;
+        auto &tt = chip_info->tile_types[type];
+        for (int b = 0; b < tt.num_bels; b++) {
+            auto &bd = tt.bel_data[b];
+            for (int i = 0; i < bd.num_bel_wires; i++) {
+                auto &bw = bd.bel_wires[i];
+                if (bw.type != PORT_OUT || bw.wire_index == -1)
+                    continue;
+                WireId wire = canonicalWireId(chip_info, tile, bw.wire_index);
+                int anchor = wire.tile == -1 ? chip_info->nodes[wire.index].tile_wires[0].tile : wire.tile;
+                int anchor_type = chip_info->tile_insts[anchor].type, intent = wireIntent(wire);
+                int ox = anchor % chip_info->width - tile_x, oy = anchor / chip_info->width - tile_y;
+                if (lookahead.query(anchor_type, intent, 0, 0) == -1)
+                    continue;
+                for (int dy = -pd.max_dy; dy <= pd.max_dy; dy++)
+                    for (int dx = -pd.max_dx; dx <= pd.max_dx; dx++) {
+                        int lx = dx - ox, ly = dy - oy;
+                        int cx = std::max(-pd.max_dx, std::min(lx, pd.max_dx));
+                        int cy = std::max(-pd.max_dy, std::min(ly, pd.max_dy));
+                        delay_t d = lookahead.query(anchor_type, intent, cx, cy);
+                        if (d == -1)
+                            continue;
+                        d += pd.outside_x * (std::abs(lx) - std::abs(cx)) + pd.outside_y * (std::abs(ly) - std::abs(cy));
+                        delay_t &t = table.at((dy + pd.max_dy) * width + (dx + pd.max_dx));
+                        if (t == -1 || d < t)
+                            t = d;
+                        any = true;
+                    }
+            }
+        }
+        if (!any || std::count(table.begin(), table.end(), -1) > 0)
+            continue;
+        pd.tile_type_class.at(type) = num_classes++;
+        pd.delays.insert(pd.delays.end(), table.begin(), table.end());
+    }
+    auto rend = std::chrono::high_resolution_clock::now();
+    log_info("Built placement delay model for %d tile types in %.02fs.\n", num_classes,
+             std::chrono::duration<float>(rend - rstart).count());
+}
+
+void Arch::setupLookahead()
+{
+    if (lookahead.ready() || bool_or_default(settings, id("arch.no_lookahead"), false))
+        return;
+    std::string filename = str_or_default(settings, id("arch.lookahead"), args.chipdb + ".lookahead");
+    uint64_t hash = chipdbHash();
+    if (loadLookahead(filename, hash)) {
+        log_info("Loaded routing lookahead from '%s'.\n", filename.c_str());
+        return;
+    }
+    buildLookahead(hash);
+    writeLookahead(filename);
+}
+
+NEXTPNR_NAMESPACE_END
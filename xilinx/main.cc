@@ -50,6 +50,9 @@ po::options_description UspCommandHandler::getArchOptions()
     specific.add_options()("chipdb", po::value<std::string>(), "name of chip database binary");
     specific.add_options()("xdc", po::value<std::vector<std::string>>(), "XDC-style constraints file");
     specific.add_options()("fasm", po::value<std::string>(), "fasm bitstream file to write");
+    specific.add_options()("lookahead", po::value<std::string>(),
+                           "routing lookahead cache file (default: chipdb filename with .lookahead appended)");
+    specific.add_options()("no-lookahead", "don't use a routing lookahead; estimate delays analytically");
 
     return specific;
 }
@@ -69,7 +72,12 @@ std::unique_ptr<Context> UspCommandHandler::createContext(std::unordered_map<std
         log_error("chip database binary must be provided\n");
     }
     chipArgs.chipdb = vm["chipdb"].as<std::string>();
-    return std::unique_ptr<Context>(new Context(chipArgs));
+    auto ctx = std::unique_ptr<Context>(new Context(chipArgs));
+    if (vm.count("lookahead"))
+        ctx->settings[ctx->id("arch.lookahead")] = vm["lookahead"].as<std::string>();
+    if (vm.count("no-lookahead"))
+        ctx->settings[ctx->id("arch.no_lookahead")] = 1;
+    return ctx;
 }
 
 void UspCommandHandler::customAfterLoad(Context *ctx)